@@ -0,0 +1,622 @@
+/*
+Microbenchmarks do firmware no host.
+Cada caso mede o tempo por operação e, pelos contadores do SDK simulado,
+o tráfego gerado nos barramentos (bytes I2C do display e palavras PIO da matriz WS2812).
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "mock.h"
+#include "sense_temp.h"
+#include "lib/ssd1306.h"
+#include "lib/ws2812.h"
+#include "lib/sprites.h"
+#include "lib/scheduler.h"
+#include "lib/refresh.h"
+#include "lib/dsp.h"
+#include "lib/calib.h"
+#include "lib/telemetry.h"
+#include "lib/flash_log.h"
+#include "lib/input.h"
+#include "lib/alarm.h"
+#include "hardware/adc.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAS_TSC 1
+#endif
+
+typedef struct {
+  const char *name;
+  void (*run)(uint32_t i);
+  uint32_t iterations;
+} bench_t;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint64_t now_ticks(void) {
+#ifdef HAS_TSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+static void bench_fill(uint32_t i) {
+  ssd1306_fill(&ssd, i & 1);
+}
+
+static void bench_rect(uint32_t i) {
+  ssd1306_rect(&ssd, i % (ssd.height - 8), i % (ssd.width - 8), 8, 8, true, true);
+  ssd1306_rect(&ssd, 0, 0, ssd.width, ssd.height, true, false);
+}
+
+static void bench_draw_string(uint32_t i) {
+  ssd1306_draw_string(&ssd, "Temperatura: ", 10, 10 + (i & 1));
+}
+
+// Campo de texto com um dígito mudando a cada chamada
+static ssd1306_text_field_t bench_field = {10, 20, 10, false, {0}};
+
+static void bench_text_field(uint32_t i) {
+  ssd1306_text_field_draw(&ssd, &bench_field, i & 1 ? "24 Graus" : "25 Graus");
+}
+
+// Dois painéis (128x64 e 128x32) no mesmo barramento, separado do display do firmware
+static ssd1306_t bench_panels[2];
+static ssd1306_text_field_t bench_panel_fields[2] = {{0, 8, 12, false, {0}}, {0, 16, 12, false, {0}}};
+
+static void bench_panels_draw(uint32_t i) {
+  char buffer[16];
+  snprintf(buffer, sizeof(buffer), "%lu", (unsigned long)i);
+  for (int p = 0; p < 2; ++p)
+    ssd1306_text_field_draw(&bench_panels[p], &bench_panel_fields[p], buffer);
+}
+
+// Cada painel enviado por conta própria: uma sessão de barramento por painel
+static void bench_panels_separate(uint32_t i) {
+  bench_panels_draw(i);
+  for (int p = 0; p < 2; ++p)
+    ssd1306_send_dirty_async(&bench_panels[p]);
+}
+
+// Os dois quadros entram juntos na fila e saem um atrás do outro
+static void bench_panels_group(uint32_t i) {
+  static ssd1306_t *const group[] = {&bench_panels[0], &bench_panels[1]};
+  bench_panels_draw(i);
+  ssd1306_send_group_async(group, 2);
+}
+
+// Sprite andando em diagonal, desalinhado das páginas, com o envio das colunas alteradas
+static ssd1306_sprite_t bench_sprite;
+
+static void bench_sprite_move(uint32_t i) {
+  ssd1306_sprite_move(&bench_panels[0], &bench_sprite, i % 120, (i * 3) % 56);
+  ssd1306_send_dirty_async(&bench_panels[0]);
+}
+
+// Partida de um painel: sequência de inicialização e o primeiro quadro completo
+static ssd1306_t bench_boot_panel;
+
+static void bench_config(uint32_t i) {
+  (void)i;
+  ssd1306_config(&bench_boot_panel);
+}
+
+static void bench_boot(uint32_t i) {
+  ssd1306_config(&bench_boot_panel);
+  ssd1306_fill(&bench_boot_panel, false);
+  ssd1306_draw_string(&bench_boot_panel, i & 1 ? "Iniciando" : "Pronto", 8, 28);
+  ssd1306_send_data(&bench_boot_panel);
+}
+
+static void bench_matrix(uint32_t i) {
+  ws2812_set_color(&matriz, i & 1 ? WS2812_RED : WS2812_GREEN);
+}
+
+// Barra vertical que só muda a cada 8 chamadas: a maioria dos envios é descartada
+static void bench_matrix_bar(uint32_t i) {
+  uint8_t level = (i / 8) % (matriz.height + 1);
+  for (uint8_t y = 0; y < matriz.height; ++y)
+    for (uint8_t x = 0; x < matriz.width; ++x)
+      ws2812_set_pixel(&matriz, x, y, matriz.height - y <= level ? WS2812_RED : 0);
+  ws2812_show(&matriz);
+}
+
+// Conversão do ADC: caminho em float (como era no firmware) contra a tabela em ponto fixo.
+// No host há FPU; no Cortex-M0+ o float é emulado e a diferença é bem maior
+static volatile int32_t bench_sink;
+static const calib_table_t bench_linear = CALIB_TABLE(CALIB_LINEAR, 0, 50000);
+static const calib_table_t bench_ntc = CALIB_TABLE(CALIB_NTC_BETA, 3950, 10000, 10000);
+
+static inline uint32_t bench_raw(uint32_t i) {
+  return (i * 2654435761u) >> 20;
+}
+
+static void bench_convert_float(uint32_t i) {
+  uint32_t raw = bench_raw(i);
+  float temperatura = (raw / 4095.0f) * 50.0f;
+  float tensao = (raw * 3.3) / 4095;
+  bench_sink = (int32_t)(temperatura * 1000.0f) + (int32_t)(tensao * 1000.0f);
+}
+
+static void bench_convert_fixed(uint32_t i) {
+  uint32_t raw = bench_raw(i);
+  bench_sink = calib_convert(&bench_linear, raw, 12) + calib_millivolts(raw, 12);
+}
+
+static void bench_ntc_float(uint32_t i) {
+  uint32_t raw = bench_raw(i) | 1;
+  float r = 10000.0f * raw / (4095.0f - raw);
+  bench_sink = (int32_t)(1000.0f * (1.0f / (1.0f / 298.15f + logf(r / 10000.0f) / 3950.0f) - 273.15f));
+}
+
+static void bench_ntc_fixed(uint32_t i) {
+  bench_sink = calib_convert(&bench_ntc, bench_raw(i), 12);
+}
+
+// Formatação da mensagem de depuração: %.2f contra inteiros
+static void bench_format_float(uint32_t i) {
+  char buffer[48];
+  float temperatura = (bench_raw(i) / 4095.0f) * 50.0f;
+  bench_sink = snprintf(buffer, sizeof(buffer), "Temperatura Simulada: %.2f", temperatura);
+}
+
+static void bench_format_fixed(uint32_t i) {
+  char buffer[48];
+  int32_t t = calib_convert(&bench_linear, bench_raw(i), 12);
+  bench_sink = snprintf(buffer, sizeof(buffer), "Temperatura Simulada: %ld.%02ld", (long)(t / 1000), (long)(t % 1000 / 10));
+}
+
+// Avança o tempo virtual o bastante para a aquisição publicar um bloco novo
+#define BENCH_FRAME_US 5000
+
+// Um quadro completo: todas as tarefas executadas uma vez
+static void frame(estado_t tela) {
+  estado = tela;
+  mock_advance_us(BENCH_FRAME_US);
+  tarefa_amostragem(NULL);
+  tarefa_alarme(NULL);
+  tarefa_leds(NULL);
+  // Os quadros vêm a cada 5 ms: sem os limites de taxa (que a troca de tela reaplica), cada
+  // quadro com mudança é desenhado e o custo medido é o de um quadro
+  refresh_set_rates(&controle_tela, 0, 0);
+  tarefa_display(NULL);
+}
+
+// Temperatura constante: o conteúdo da tela não muda entre quadros
+static void bench_frame_steady(uint32_t i) {
+  (void)i;
+  mock_set_adc(0, 2000);
+  frame(ESTADO_TEMPERATURA);
+}
+
+// Temperatura variando a cada quadro dentro da faixa normal (sem buzzer)
+static void bench_frame_changing(uint32_t i) {
+  mock_set_adc(0, 1300 + (i * 37) % 1500);
+  frame(ESTADO_TEMPERATURA);
+}
+
+static void bench_frame_square(uint32_t i) {
+  mock_set_adc(1, (i * 53) % 4096);
+  mock_set_adc(0, (i * 97) % 4096);
+  frame(ESTADO_QUADRADO);
+}
+
+// Gráfico do histórico com uma amostra nova por quadro: rola no painel e envia uma coluna
+static void bench_frame_history(uint32_t i) {
+  mock_set_adc(0, 1300 + (i * 37) % 1500);
+  tarefa_historico(NULL);
+  frame(ESTADO_HISTORICO);
+}
+
+static const bench_t benches[] = {
+  {"ssd1306_fill", bench_fill, 20000},
+  {"ssd1306_rect", bench_rect, 20000},
+  {"ssd1306_draw_string", bench_draw_string, 20000},
+  {"campo de texto", bench_text_field, 20000},
+  {"2 painéis (separados)", bench_panels_separate, 20000},
+  {"2 painéis (grupo)", bench_panels_group, 20000},
+  {"sprite + envio", bench_sprite_move, 20000},
+  {"ssd1306_config", bench_config, 20000},
+  {"partida (1º quadro)", bench_boot, 20000},
+  {"ws2812_set_color", bench_matrix, 20000},
+  {"matriz (barra)", bench_matrix_bar, 20000},
+  {"conversão float", bench_convert_float, 200000},
+  {"conversão ponto fixo", bench_convert_fixed, 200000},
+  {"NTC float (logf)", bench_ntc_float, 200000},
+  {"NTC tabela", bench_ntc_fixed, 200000},
+  {"formato %.2f", bench_format_float, 200000},
+  {"formato inteiro", bench_format_fixed, 200000},
+  {"quadro (estável)", bench_frame_steady, 5000},
+  {"quadro (variando)", bench_frame_changing, 5000},
+  {"quadro (quadrado)", bench_frame_square, 5000},
+  {"quadro (histórico)", bench_frame_history, 5000},
+};
+
+// Roteiro dos botões: bordas com repique em tempo virtual, entregues por um alarme
+typedef struct {
+  uint32_t at_ms;
+  uint8_t gpio;
+  bool level;
+} bench_edge_t;
+
+#define BENCH_BOTAO_A 5
+#define BENCH_BOTAO_B 6
+
+static const bench_edge_t bench_edges[] = {
+  // B pressionado com 3 repiques e solto com 2: abre o histórico
+  {100, BENCH_BOTAO_B, 0}, {101, BENCH_BOTAO_B, 1}, {102, BENCH_BOTAO_B, 0}, {104, BENCH_BOTAO_B, 1},
+  {105, BENCH_BOTAO_B, 0}, {180, BENCH_BOTAO_B, 1}, {181, BENCH_BOTAO_B, 0}, {183, BENCH_BOTAO_B, 1},
+  // Pulso de 2 ms: ruído, sem evento
+  {400, BENCH_BOTAO_B, 0}, {402, BENCH_BOTAO_B, 1},
+  // B outra vez: volta à temperatura
+  {600, BENCH_BOTAO_B, 0}, {601, BENCH_BOTAO_B, 1}, {602, BENCH_BOTAO_B, 0}, {700, BENCH_BOTAO_B, 1},
+  // A segurado por 1,6 s: pressionar, toque longo, duas repetições e soltar
+  {1000, BENCH_BOTAO_A, 0}, {1001, BENCH_BOTAO_A, 1}, {1002, BENCH_BOTAO_A, 0}, {2600, BENCH_BOTAO_A, 1},
+};
+
+static uint bench_edge_next;
+
+static int64_t bench_edge_alarm(alarm_id_t id, void *data) {
+  (void)id;
+  uint64_t start = *(uint64_t *)data;
+  const bench_edge_t *edge = &bench_edges[bench_edge_next++];
+  mock_gpio_input(edge->gpio, edge->level);
+  if (bench_edge_next == sizeof(bench_edges) / sizeof(bench_edges[0]))
+    return 0;
+  return (int64_t)(start + bench_edges[bench_edge_next].at_ms * 1000ull) - (int64_t)time_us_64();
+}
+
+// Roteiro do alarme (miligraus): rampa de 1 grau/s que cruza os 35 graus aos 10 s, patamar,
+// volta a 33 graus e depois oscila 0,2 grau em torno do limite a cada 50 ms
+static int32_t bench_alarm_mgraus(uint32_t ms) {
+  if (ms < 11000)
+    return 25000 + (int32_t)ms;
+  if (ms < 13000)
+    return 36000;
+  if (ms < 15000)
+    return 33000;
+  return (ms / 50) % 2 ? 35200 : 34800;
+}
+
+typedef struct {
+  uint64_t start_us;
+  int32_t last;
+  uint32_t crossings;      // cruzamentos do limite no sinal: as trocas de faixa sem histerese
+  uint32_t changes;        // trocas da faixa confirmada
+  uint32_t predicted_ms;   // primeira previsão da faixa alta
+  uint32_t high_ms;        // primeira confirmação da faixa alta
+  faixa_t faixa;
+} bench_alarm_run_t;
+
+#define BENCH_ALARM_MS 18000
+
+static int64_t bench_alarm_step(alarm_id_t id, void *data) {
+  (void)id;
+  bench_alarm_run_t *run = data;
+  uint32_t ms = (uint32_t)((time_us_64() - run->start_us) / 1000);
+  int32_t mgraus = bench_alarm_mgraus(ms);
+  if ((mgraus > 35000) != (run->last > 35000))
+    run->crossings++;
+  run->last = mgraus;
+  mock_set_adc(0, (uint16_t)(mgraus * 4095 / 50000));
+
+  if (!run->predicted_ms && faixa_prevista == FAIXA_ALTA)
+    run->predicted_ms = ms;
+  if (!run->high_ms && faixa == FAIXA_ALTA)
+    run->high_ms = ms;
+  if (faixa != run->faixa) {
+    run->changes++;
+    run->faixa = faixa;
+  }
+  return ms < BENCH_ALARM_MS ? 10000 : 0;
+}
+
+// Filtros DSP sobre a carga do firmware: blocos de 16 amostras de 12 bits por entrada (o que o
+// DMA entrega a 5 kHz com 2 bits de sobreamostragem), em torno de 2048 com ruído uniforme de
+// ±16 LSB e 1% de picos de +800 LSB
+#define DSP_BLOCK 16
+#define DSP_SAMPLES 4096
+#define DSP_ROUNDS 200
+#define DSP_LEVEL 2048
+#define DSP_RATE_HZ 5000
+
+static int16_t dsp_input[DSP_SAMPLES];
+static int16_t dsp_output[DSP_SAMPLES];
+static int32_t dsp_decimated[DSP_SAMPLES];
+
+// Butterworth de segunda ordem com corte em 1/20 da taxa
+static const dsp_biquad_coeffs_t bench_biquad_coeffs = {
+  DSP_Q14(0.0200834), DSP_Q14(0.0401667), DSP_Q14(0.0200834), DSP_Q14(-1.5610181), DSP_Q14(0.6413515),
+};
+
+// Os mesmos coeficientes do filtro do joystick em sense_temp.c
+static const int16_t bench_fir_taps[32] = {
+  6, 23, 51, 104, 189, 313, 482, 692, 940, 1213, 1497, 1774, 2026, 2234, 2382, 2458,
+  2458, 2382, 2234, 2026, 1774, 1497, 1213, 940, 692, 482, 313, 189, 104, 51, 23, 6,
+};
+
+// Média de 16 amostras, como a sobreamostragem fazia antes dos filtros (FIR de coeficientes iguais)
+static const int16_t bench_box_taps[16] = {
+  2048, 2048, 2048, 2048, 2048, 2048, 2048, 2048, 2048, 2048, 2048, 2048, 2048, 2048, 2048, 2048,
+};
+
+typedef enum {
+  DSP_MOVING_AVERAGE,
+  DSP_MEDIAN3,
+  DSP_MEDIAN5,
+  DSP_IIR1,
+  DSP_BIQUAD,
+  DSP_BOX,
+  DSP_FIR,
+  DSP_CHAIN,
+} dsp_kernel_t;
+
+typedef struct {
+  const char *name;
+  dsp_kernel_t kernel;
+} dsp_bench_t;
+
+static const dsp_bench_t dsp_benches[] = {
+  {"média móvel (16)", DSP_MOVING_AVERAGE},
+  {"mediana de 3", DSP_MEDIAN3},
+  {"mediana de 5", DSP_MEDIAN5},
+  {"IIR 1ª ordem", DSP_IIR1},
+  {"biquad", DSP_BIQUAD},
+  {"média do bloco (/16)", DSP_BOX},
+  {"FIR 32 (/16)", DSP_FIR},
+  {"mediana 3 + FIR (/16)", DSP_CHAIN},
+};
+
+// Processa o sinal inteiro em blocos; retorna quantas saídas ficaram em dsp_output
+static uint dsp_run(dsp_kernel_t kernel) {
+  static dsp_moving_average_t average;
+  static dsp_median_t median;
+  static dsp_iir1_t iir;
+  static dsp_biquad_t biquad;
+  static dsp_fir_t fir;
+  uint produced = 0;
+
+  switch (kernel) {
+    case DSP_MOVING_AVERAGE: dsp_moving_average_init(&average, 4); break;
+    case DSP_MEDIAN3: case DSP_CHAIN: dsp_median_init(&median, 3); break;
+    case DSP_MEDIAN5: dsp_median_init(&median, 5); break;
+    case DSP_IIR1: dsp_iir1_init(&iir, 3); break;
+    case DSP_BIQUAD: dsp_biquad_init(&biquad, &bench_biquad_coeffs); break;
+    case DSP_BOX: dsp_fir_init(&fir, bench_box_taps, 16, DSP_BLOCK, 0); break;
+    case DSP_FIR: break;
+  }
+  if (kernel == DSP_FIR || kernel == DSP_CHAIN)
+    dsp_fir_init(&fir, bench_fir_taps, 32, DSP_BLOCK, 0);
+
+  for (uint i = 0; i < DSP_SAMPLES; i += DSP_BLOCK) {
+    const int16_t *in = &dsp_input[i];
+    int16_t *out = &dsp_output[i];
+    switch (kernel) {
+      case DSP_MOVING_AVERAGE: dsp_moving_average(&average, in, out, DSP_BLOCK); break;
+      case DSP_MEDIAN3: case DSP_MEDIAN5: dsp_median(&median, in, out, DSP_BLOCK); break;
+      case DSP_IIR1: dsp_iir1(&iir, in, out, DSP_BLOCK); break;
+      case DSP_BIQUAD: dsp_biquad(&biquad, in, out, DSP_BLOCK); break;
+      case DSP_BOX: case DSP_FIR:
+        produced += dsp_fir_decimate(&fir, in, &dsp_decimated[produced], DSP_BLOCK);
+        continue;
+      case DSP_CHAIN: {
+        int16_t block[DSP_BLOCK];
+        dsp_median(&median, in, block, DSP_BLOCK);
+        produced += dsp_fir_decimate(&fir, block, &dsp_decimated[produced], DSP_BLOCK);
+        continue;
+      }
+    }
+    produced += DSP_BLOCK;
+  }
+
+  if (kernel == DSP_BOX || kernel == DSP_FIR || kernel == DSP_CHAIN) {
+    for (uint i = 0; i < produced; ++i)
+      dsp_output[i] = (int16_t)dsp_decimated[i];
+  }
+  return produced;
+}
+
+static void bench_dsp(void) {
+  uint32_t seed = 12345;
+  for (uint i = 0; i < DSP_SAMPLES; ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    int16_t noise = (int16_t)((seed >> 16) % 33) - 16;
+    dsp_input[i] = DSP_LEVEL + noise + ((seed >> 8) % 100 == 0 ? 800 : 0);
+  }
+
+  printf("\nfiltros DSP: blocos de %d amostras a %d Hz, ruído de ±16 LSB e 1%% de picos de +800 LSB\n",
+         DSP_BLOCK, DSP_RATE_HZ);
+  printf("%-22s %12s %12s %12s %12s\n", "filtro", "ns/amostra", "ticks/amostra", "erro rms", "erro máx");
+
+  for (size_t b = 0; b < sizeof(dsp_benches) / sizeof(dsp_benches[0]); ++b) {
+    const dsp_bench_t *bench = &dsp_benches[b];
+    uint64_t t0 = now_ns();
+    uint64_t c0 = now_ticks();
+    uint produced = 0;
+    for (uint round = 0; round < DSP_ROUNDS; ++round)
+      produced = dsp_run(bench->kernel);
+    uint64_t c1 = now_ticks();
+    uint64_t t1 = now_ns();
+
+    // Erro em relação ao nível sem ruído, descontando a partida dos filtros
+    double sum = 0;
+    int32_t worst = 0;
+    uint settled = produced / 8;
+    for (uint i = settled; i < produced; ++i) {
+      int32_t error = dsp_output[i] - DSP_LEVEL;
+      sum += (double)error * error;
+      if (abs(error) > worst)
+        worst = abs(error);
+    }
+
+    double n = (double)DSP_ROUNDS * DSP_SAMPLES;
+    printf("%-22s %12.2f %12.2f %12.2f %12d\n", bench->name, (t1 - t0) / n, (c1 - c0) / n,
+           sqrt(sum / (produced - settled)), worst);
+  }
+}
+
+int main(int argc, char **argv) {
+  // Opcional: grava a telemetria enviada pela USB para conferir com tools/telemetry_decode
+  FILE *telemetry_file = NULL;
+  if (argc > 1 && (telemetry_file = fopen(argv[1], "wb")))
+    mock_set_usb_output(telemetry_file);
+
+  inicializa();
+
+  i2c_init(i2c0, 400 * 1000);
+  ssd1306_init(&bench_panels[0], 128, 64, false, 0x3C, i2c0);
+  ssd1306_init(&bench_panels[1], 128, 32, false, 0x3D, i2c0);
+  for (int p = 0; p < 2; ++p) {
+    ssd1306_config(&bench_panels[p]);
+    ssd1306_async_init(&bench_panels[p]);
+  }
+  i2c_init(i2c1, 400 * 1000);
+  ssd1306_init(&bench_boot_panel, 128, 64, false, 0x3C, i2c1);
+  ssd1306_sprite_init(&bench_sprite, &sprite_atlas[SPRITE_SQUARE], SSD1306_BLIT_COPY);
+
+  printf("%-22s %12s %12s %12s %12s %12s\n", "caso", "ns/op", "ticks/op", "bytes I2C", "transações", "palavras PIO");
+
+  for (size_t b = 0; b < sizeof(benches) / sizeof(benches[0]); ++b) {
+    const bench_t *bench = &benches[b];
+    ssd1306_bus_stats_t bus0, bus1;
+
+    mock_reset_stats();
+    ssd1306_get_bus_stats(i2c0, &bus0);
+    uint64_t t0 = now_ns();
+    uint64_t c0 = now_ticks();
+    for (uint32_t i = 0; i < bench->iterations; ++i)
+      bench->run(i);
+    uint64_t c1 = now_ticks();
+    uint64_t t1 = now_ns();
+
+    double n = bench->iterations;
+    printf("%-22s %12.1f %12.1f %12.1f %12.2f %12.1f\n",
+           bench->name,
+           (t1 - t0) / n,
+           (c1 - c0) / n,
+           mock_stats.i2c_bytes / n,
+           mock_stats.i2c_transactions / n,
+           mock_stats.pio_words / n);
+
+    // Casos no barramento dos painéis extras: quantos quadros saíram por sessão
+    ssd1306_get_bus_stats(i2c0, &bus1);
+    if (bus1.frames != bus0.frames)
+      printf("%-22s %.2f sessões/op, %.2f quadros/sessão, %.2f trocas de endereço/op\n", "",
+             (bus1.sessions - bus0.sessions) / n,
+             (double)(bus1.frames - bus0.frames) / (bus1.sessions - bus0.sessions),
+             (bus1.switches - bus0.switches) / n);
+  }
+
+  // Escalonador rodando um segundo de tempo virtual na tela de temperatura
+  estado = ESTADO_TEMPERATURA;
+  aplica_periodos();
+  mock_set_adc(0, 2000);
+  mock_reset_stats();
+  scheduler_reset_stats();
+  refresh_reset_stats(&controle_tela);
+  uint64_t t0 = now_ns();
+  scheduler_run_until(delayed_by_ms(get_absolute_time(), 1000));
+  uint64_t t1 = now_ns();
+
+  scheduler_stats_t duty;
+  scheduler_get_stats(&duty);
+  printf("\nescalonador: 1 s virtual em %.2f ms de host, %.1f bytes I2C, %.1f bytes USB, "
+         "%u conversões do ADC, %u despertares\n",
+         (t1 - t0) / 1e6, (double)mock_stats.i2c_bytes, (double)mock_stats.usb_bytes,
+         mock_stats.adc_reads, duty.wakeups);
+  for (int task = 0; task < SCHEDULER_MAX_TASKS && scheduler_get(task)->fn; ++task)
+    printf("  %-12s %6u execuções %6u atrasos\n", scheduler_get(task)->name, scheduler_get(task)->runs, scheduler_get(task)->overruns);
+
+  printf("tela: %u quadros avaliados, %u desenhados, %u completos, %.1f%% pulados\n",
+         controle_tela.stats.evaluated, controle_tela.stats.rendered, controle_tela.stats.forced,
+         refresh_skipped_permille(&controle_tela) / 10.0);
+
+  const telemetry_stats_t *telemetry = telemetry_stats();
+  printf("telemetria: %u registros, %u pacotes, %u descartados, %u bytes\n",
+         telemetry->records, telemetry->packets, telemetry->dropped, telemetry->bytes);
+
+  // Baixo consumo: 10 s virtuais com uma amostra por segundo. As tarefas não gastam tempo
+  // virtual no host, então a comparação é pelos despertares e pelo trabalho dos periféricos
+  define_modo(true, 1000);
+  mock_reset_stats();
+  scheduler_reset_stats();
+  scheduler_run_until(delayed_by_ms(get_absolute_time(), 10000));
+  scheduler_get_stats(&duty);
+  printf("baixo consumo: por segundo %.1f bytes I2C, %.1f conversões do ADC, %.1f despertares\n",
+         mock_stats.i2c_bytes / 10.0, mock_stats.adc_reads / 10.0, duty.wakeups / 10.0);
+  define_modo(false, 20);
+
+  // Botões: as bordas chegam em tempo virtual enquanto o escalonador roda. A latência é da
+  // primeira borda até a tarefa dos botões tratar o evento, com os 20 ms de debounce incluídos
+  input_reset_stats();
+  mock_reset_stats();
+  scheduler_reset_stats();
+  uint64_t edges_start = time_us_64();
+  bench_edge_next = 0;
+  add_alarm_in_us(bench_edges[0].at_ms * 1000, bench_edge_alarm, &edges_start, true);
+  scheduler_run_until(delayed_by_ms(get_absolute_time(), 3000));
+  input_stats_t input;
+  input_get_stats(&input);
+  scheduler_get_stats(&duty);
+  printf("botões: %u bordas, %u repiques, %u eventos tratados, latência média %.1f ms, máx %.1f ms "
+         "(máx na fila %u us), %u despertares em 3 s\n",
+         input.edges, input.bounces, input.handled, input.handled ? input.latency_sum_us / 1e3 / input.handled : 0.0,
+         input.latency_max_us / 1e3, input.queue_max_us, duty.wakeups);
+  estado = ESTADO_TEMPERATURA;
+
+  // Alarme: o roteiro muda a entrada do ADC a cada 10 ms enquanto o escalonador roda. A
+  // previsão deve vir antes do cruzamento (10 s) e a oscilação em torno do limite não deve
+  // trocar a faixa; a latência é do bloco do ADC até os LEDs e o buzzer serem acionados
+  mock_set_adc(0, 25000 * 4095 / 50000);
+  scheduler_run_until(delayed_by_ms(get_absolute_time(), 1000));
+  alarm_reset_stats();
+  refresh_reset_stats(&controle_tela);
+  mock_reset_stats();
+  bench_alarm_run_t alarm_run = {time_us_64(), 25000, 0, 0, 0, 0, faixa};
+  add_alarm_in_us(0, bench_alarm_step, &alarm_run, true);
+  scheduler_run_until(delayed_by_ms(get_absolute_time(), BENCH_ALARM_MS + 100));
+  alarm_stats_t alarm;
+  alarm_get_stats(&alarm);
+  printf("alarme: previsão aos %.2f s e faixa alta aos %.2f s (limite cruzado aos 10.00 s), "
+         "%u trocas de faixa para %u cruzamentos, %u eventos (%u previsões), %u oscilações evitadas, "
+         "latência média %.1f ms, máx %.1f ms\n",
+         alarm_run.predicted_ms / 1e3, alarm_run.high_ms / 1e3, alarm_run.changes, alarm_run.crossings,
+         alarm.events, alarm.predictions, alarm.suppressed,
+         alarm.actuated ? alarm.latency_sum_us / 1e3 / alarm.actuated : 0.0, alarm.latency_max_us / 1e3);
+  printf("tela no roteiro do alarme: %u quadros avaliados, %u desenhados, %u completos, %u adiados, "
+         "%.1f%% pulados, %.1f bytes I2C/s, %u escritas nos LEDs\n",
+         controle_tela.stats.evaluated, controle_tela.stats.rendered, controle_tela.stats.forced,
+         controle_tela.stats.deferred, refresh_skipped_permille(&controle_tela) / 10.0,
+         mock_stats.i2c_bytes / (BENCH_ALARM_MS / 1000.0), mock_stats.gpio_puts);
+
+  // Log na flash: 10 mil amostras (1h23 a 500 ms) dão várias voltas no rodízio dos setores;
+  // depois a retomada lê só os cabeçalhos e a primeira palavra das páginas
+  mock_reset_stats();
+  t0 = now_ns();
+  for (uint32_t i = 0; i < 10000; ++i) {
+    if (flash_log_append((int16_t)i, 0))
+      flash_log_commit();
+  }
+  t1 = now_ns();
+  flash_log_init();
+  uint64_t t2 = now_ns();
+  printf("log da flash: %.1f ns/registro, %u páginas gravadas, %u setores apagados, retomada em %.1f us "
+         "(registros %u a %u)\n",
+         (t1 - t0) / 10000.0, mock_stats.flash_programs, mock_stats.flash_erases, (t2 - t1) / 1e3,
+         flash_log_first(), flash_log_next() - 1);
+
+  bench_dsp();
+
+  if (telemetry_file)
+    fclose(telemetry_file);
+  return 0;
+}
@@ -0,0 +1,28 @@
+#ifndef MOCK_HARDWARE_IRQ_H
+#define MOCK_HARDWARE_IRQ_H
+
+#include "pico/types.h"
+
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+
+enum irq_num {
+  TIMER_IRQ_0 = 0,
+  TIMER_IRQ_1 = 1,
+  TIMER_IRQ_2 = 2,
+  TIMER_IRQ_3 = 3,
+  PWM_IRQ_WRAP = 4,
+  DMA_IRQ_0 = 11,
+  DMA_IRQ_1 = 12,
+  IO_IRQ_BANK0 = 13,
+  I2C0_IRQ = 23,
+  I2C1_IRQ = 24,
+  NUM_IRQS = 32,
+};
+
+typedef void (*irq_handler_t)(void);
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority);
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+void irq_set_enabled(uint num, bool enabled);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef MOCK_HARDWARE_PWM_H
+#define MOCK_HARDWARE_PWM_H
+
+#include "pico/types.h"
+
+#define NUM_PWM_SLICES 8
+
+enum pwm_chan {
+  PWM_CHAN_A = 0,
+  PWM_CHAN_B = 1,
+};
+
+static inline uint pwm_gpio_to_slice_num(uint gpio) { return (gpio >> 1u) & 7u; }
+static inline uint pwm_gpio_to_channel(uint gpio) { return gpio & 1u; }
+
+void pwm_set_clkdiv_int_frac(uint slice_num, uint8_t integer, uint8_t fract);
+void pwm_set_wrap(uint slice_num, uint16_t wrap);
+void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level);
+void pwm_set_enabled(uint slice_num, bool enabled);
+
+// Inspeção do estado simulado: frequência (Hz) e nível atuais do canal
+uint32_t mock_pwm_frequency(uint slice_num);
+uint16_t mock_pwm_level(uint slice_num, uint chan);
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef MOCK_HARDWARE_SYNC_H
+#define MOCK_HARDWARE_SYNC_H
+
+#include "pico/types.h"
+
+// No host não há interrupções reais: as seções críticas não precisam fazer nada
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+static inline void __dmb(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __sev(void) {}
+static inline void __wfe(void) {}
+
+// Dormir avança o tempo virtual até o próximo alarme agendado
+void __wfi(void);
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef MOCK_PICO_ERROR_H
+#define MOCK_PICO_ERROR_H
+
+// Códigos de retorno do SDK usados pelo firmware
+enum pico_error_codes {
+  PICO_OK = 0,
+  PICO_ERROR_GENERIC = -1,
+  PICO_ERROR_TIMEOUT = -2,
+};
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef MOCK_PICO_FLASH_H
+#define MOCK_PICO_FLASH_H
+
+#include "pico/types.h"
+#include "pico/error.h"
+
+// No host não há outro núcleo nem interrupções a suspender: a função roda direto
+int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms);
+bool flash_safe_execute_core_init(void);
+
+#endif
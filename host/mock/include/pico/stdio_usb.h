@@ -0,0 +1,14 @@
+#ifndef MOCK_PICO_STDIO_USB_H
+#define MOCK_PICO_STDIO_USB_H
+
+#include "pico/types.h"
+
+typedef struct stdio_driver {
+  void (*out_chars)(const char *buf, int len);
+  void (*out_flush)(void);
+} stdio_driver_t;
+
+// Driver de stdio sobre a porta CDC da USB
+extern stdio_driver_t stdio_usb;
+
+#endif
@@ -0,0 +1,28 @@
+/*
+Substituto de pico/stdlib.h para a compilação no computador (host).
+Reúne os tipos básicos, as funções de tempo e de GPIO usadas pelo firmware.
+*/
+
+#ifndef MOCK_PICO_STDLIB_H
+#define MOCK_PICO_STDLIB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "pico/error.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+bool stdio_init_all(void);
+
+// Sem entrada no host: nenhum caractere chega pela serial
+int getchar_timeout_us(uint32_t timeout_us);
+
+static inline void tight_loop_contents(void) {}
+
+// O host roda tudo em um só núcleo
+static inline uint get_core_num(void) { return 0; }
+
+#endif
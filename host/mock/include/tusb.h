@@ -0,0 +1,16 @@
+/*
+TinyUSB do host: a porta CDC está sempre conectada e aceita até um FIFO de 256 bytes por chamada.
+Os bytes escritos são contados e, se configurado, copiados para um arquivo (mock_set_usb_output).
+*/
+
+#ifndef MOCK_TUSB_H
+#define MOCK_TUSB_H
+
+#include "pico/types.h"
+
+bool tud_cdc_connected(void);
+uint32_t tud_cdc_write_available(void);
+uint32_t tud_cdc_write(const void *buffer, uint32_t bufsize);
+uint32_t tud_cdc_write_flush(void);
+
+#endif
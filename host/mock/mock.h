@@ -0,0 +1,55 @@
+/*
+Interface de inspeção do SDK simulado: contadores de uso dos periféricos e controle do tempo virtual.
+Benchmarks e ferramentas do host leem esses contadores para medir o custo de cada operação.
+*/
+
+#ifndef MOCK_H
+#define MOCK_H
+
+#include <stdio.h>
+#include "pico/types.h"
+
+typedef struct {
+  uint64_t i2c_bytes;         // bytes de dados entregues ao barramento I2C
+  uint32_t i2c_transactions;  // transações (START ... STOP)
+  uint64_t pio_words;         // palavras escritas nos FIFOs do PIO
+  uint32_t dma_transfers;     // disparos de DMA
+  uint32_t gpio_puts;         // chamadas a gpio_put
+  uint32_t adc_reads;         // chamadas a adc_read
+  uint64_t sleep_us;          // tempo virtual gasto em sleep_*
+  uint64_t usb_bytes;         // bytes escritos na porta CDC da USB
+  uint32_t flash_erases;      // setores apagados
+  uint32_t flash_programs;    // páginas gravadas
+} mock_stats_t;
+
+extern mock_stats_t mock_stats;
+
+void mock_reset_stats(void);
+void mock_advance_us(uint64_t us);
+
+// Valor retornado por adc_read para cada entrada do ADC
+void mock_set_adc(uint input, uint16_t value);
+
+// Muda o nível de uma entrada, chamando o callback de interrupção do GPIO se a borda estiver habilitada
+void mock_gpio_input(uint gpio, bool value);
+
+// Copia tudo o que é escrito na porta CDC da USB para o arquivo (NULL desliga)
+void mock_set_usb_output(FILE *file);
+
+// Apaga toda a flash simulada (0xFF), como uma placa nova
+void mock_flash_reset(void);
+
+// Observadores do tráfego, para os emuladores do simulador: cada byte escrito num barramento
+// I2C (com o endereço de destino e se encerra a transação) e cada palavra entregue ao FIFO de
+// uma máquina de estados do PIO. NULL desliga
+typedef void (*mock_i2c_tap_t)(uint i2c_index, uint8_t address, uint8_t byte, bool stop);
+typedef void (*mock_pio_tap_t)(uint pio_index, uint sm, uint32_t word);
+void mock_set_i2c_tap(mock_i2c_tap_t tap);
+void mock_set_pio_tap(mock_pio_tap_t tap);
+
+// Com true, o DMA para o I2C leva o tempo do barramento: cada byte ocupa 9 bits na taxa de
+// i2c_init e o fim da transferência (sua interrupção) chega depois, como na placa. Com false
+// (padrão) a transferência termina na hora, o que os microbenchmarks usam para medir cada envio
+void mock_set_i2c_timing(bool enabled);
+
+#endif
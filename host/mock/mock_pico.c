@@ -0,0 +1,863 @@
+/*
+Implementação do SDK simulado para o host.
+Nenhum periférico existe de fato: as chamadas apenas contam bytes e operações e avançam o tempo virtual.
+*/
+
+#include <string.h>
+
+#include "mock.h"
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/flash.h"
+#include "hardware/i2c.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+#include "pico/flash.h"
+#include "pico/stdio_usb.h"
+#include "tusb.h"
+
+mock_stats_t mock_stats;
+
+static uint64_t now_us;
+static bool gpio_state[NUM_BANK0_GPIOS];
+// O sensor interno começa em 0,706 V (27 °C)
+static uint16_t adc_value[5] = {[4] = 876};
+static uint adc_input;
+
+i2c_inst_t i2c0_inst = {.index = 0};
+i2c_inst_t i2c1_inst = {.index = 1};
+pio_hw_t pio0_hw = {.index = 0};
+pio_hw_t pio1_hw = {.index = 1};
+
+void mock_reset_stats(void) {
+  memset(&mock_stats, 0, sizeof(mock_stats));
+}
+
+static void mock_adc_pump(void);
+static void mock_i2c_pump(void);
+static bool mock_fire_next_alarm(uint64_t until);
+
+// Avança o tempo virtual disparando, em ordem, os alarmes que vencem no intervalo
+void mock_advance_us(uint64_t us) {
+  uint64_t target = now_us + us;
+  while (mock_fire_next_alarm(target))
+    ;
+  now_us = target;
+  mock_adc_pump();
+  mock_i2c_pump();
+}
+
+void mock_set_adc(uint input, uint16_t value) {
+  if (input < sizeof(adc_value) / sizeof(adc_value[0]))
+    adc_value[input] = value & 0x0FFF;
+}
+
+// ---------------------------------------------------------------- USB
+
+#define MOCK_CDC_FIFO_SIZE 256
+
+static FILE *usb_output;
+
+void mock_set_usb_output(FILE *file) {
+  usb_output = file;
+}
+
+bool tud_cdc_connected(void) {
+  return true;
+}
+
+uint32_t tud_cdc_write_available(void) {
+  return MOCK_CDC_FIFO_SIZE;
+}
+
+uint32_t tud_cdc_write(const void *buffer, uint32_t bufsize) {
+  if (bufsize > MOCK_CDC_FIFO_SIZE)
+    bufsize = MOCK_CDC_FIFO_SIZE;
+  mock_stats.usb_bytes += bufsize;
+  if (usb_output)
+    fwrite(buffer, 1, bufsize, usb_output);
+  return bufsize;
+}
+
+uint32_t tud_cdc_write_flush(void) {
+  return 0;
+}
+
+static void mock_stdio_usb_out_chars(const char *buf, int len) {
+  while (len > 0) {
+    uint32_t n = tud_cdc_write(buf, len);
+    buf += n;
+    len -= n;
+  }
+}
+
+static void mock_stdio_usb_out_flush(void) {
+}
+
+stdio_driver_t stdio_usb = {mock_stdio_usb_out_chars, mock_stdio_usb_out_flush};
+
+// ---------------------------------------------------------------- flash
+
+uint8_t mock_flash[PICO_FLASH_SIZE_BYTES];
+
+__attribute__((constructor)) void mock_flash_reset(void) {
+  memset(mock_flash, 0xFF, sizeof(mock_flash));
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+  if (flash_offs % FLASH_SECTOR_SIZE || count % FLASH_SECTOR_SIZE || flash_offs + count > PICO_FLASH_SIZE_BYTES)
+    return;
+  memset(mock_flash + flash_offs, 0xFF, count);
+  mock_stats.flash_erases += count / FLASH_SECTOR_SIZE;
+}
+
+// Gravar só consegue levar bits de 1 para 0, como na flash real
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+  if (flash_offs % FLASH_PAGE_SIZE || count % FLASH_PAGE_SIZE || flash_offs + count > PICO_FLASH_SIZE_BYTES)
+    return;
+  for (size_t i = 0; i < count; ++i)
+    mock_flash[flash_offs + i] &= data[i];
+  mock_stats.flash_programs += count / FLASH_PAGE_SIZE;
+}
+
+int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms) {
+  (void)enter_exit_timeout_ms;
+  func(param);
+  return PICO_OK;
+}
+
+bool flash_safe_execute_core_init(void) {
+  return true;
+}
+
+// ---------------------------------------------------------------- stdio e tempo
+
+bool stdio_init_all(void) {
+  return true;
+}
+
+int getchar_timeout_us(uint32_t timeout_us) {
+  (void)timeout_us;
+  return PICO_ERROR_TIMEOUT;
+}
+
+uint64_t time_us_64(void) {
+  return now_us;
+}
+
+void sleep_us(uint64_t us) {
+  mock_stats.sleep_us += us;
+  mock_advance_us(us);
+}
+
+void sleep_ms(uint32_t ms) {
+  sleep_us(1000ull * ms);
+}
+
+void sleep_until(absolute_time_t target) {
+  if (target > now_us)
+    sleep_us(target - now_us);
+}
+
+// ---------------------------------------------------------------- alarmes
+
+#define MOCK_MAX_ALARMS 32
+
+typedef struct {
+  alarm_id_t id;
+  uint64_t time;
+  alarm_callback_t callback;
+  void *user_data;
+} mock_alarm_t;
+
+static mock_alarm_t alarms[MOCK_MAX_ALARMS];
+static alarm_id_t next_alarm_id = 1;
+
+// Executa o callback e devolve o próximo instante (0 = não reagendar), como o SDK
+static uint64_t mock_run_alarm(alarm_id_t id, uint64_t scheduled, alarm_callback_t callback, void *user_data) {
+  int64_t delay = callback(id, user_data);
+  if (!delay)
+    return 0;
+  return delay < 0 ? scheduled + (uint64_t)(-delay) : now_us + (uint64_t)delay;
+}
+
+alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+  alarm_id_t id = next_alarm_id++;
+
+  while (time <= now_us) {
+    if (!fire_if_past)
+      return 0;
+    time = mock_run_alarm(id, time, callback, user_data);
+    if (!time)
+      return 0;
+  }
+
+  for (uint i = 0; i < MOCK_MAX_ALARMS; ++i) {
+    if (!alarms[i].callback) {
+      alarms[i] = (mock_alarm_t){id, time, callback, user_data};
+      return id;
+    }
+  }
+  return -1;
+}
+
+bool cancel_alarm(alarm_id_t alarm_id) {
+  for (uint i = 0; i < MOCK_MAX_ALARMS; ++i) {
+    if (alarms[i].callback && alarms[i].id == alarm_id) {
+      alarms[i].callback = NULL;
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool mock_fire_next_alarm(uint64_t until) {
+  mock_alarm_t *next = NULL;
+  for (uint i = 0; i < MOCK_MAX_ALARMS; ++i) {
+    if (alarms[i].callback && alarms[i].time <= until && (!next || alarms[i].time < next->time))
+      next = &alarms[i];
+  }
+  if (!next)
+    return false;
+
+  if (next->time > now_us)
+    now_us = next->time;
+  mock_adc_pump();
+  mock_i2c_pump();
+
+  // O alarme sai da lista antes do callback, que pode cancelar ou criar outros
+  mock_alarm_t fired = *next;
+  next->callback = NULL;
+  uint64_t again = mock_run_alarm(fired.id, fired.time, fired.callback, fired.user_data);
+  if (again) {
+    for (uint i = 0; i < MOCK_MAX_ALARMS; ++i) {
+      if (!alarms[i].callback) {
+        alarms[i] = (mock_alarm_t){fired.id, again, fired.callback, fired.user_data};
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+static bool mock_adc_next_us(uint64_t *time);
+static bool mock_i2c_next_us(uint64_t *time);
+
+// Acorda no próximo alarme ou no fim de uma transferência de DMA (sua interrupção): o bloco do
+// ADC ou o quadro no I2C, o que vier antes
+void __wfi(void) {
+  mock_alarm_t *next = NULL;
+  for (uint i = 0; i < MOCK_MAX_ALARMS; ++i) {
+    if (alarms[i].callback && (!next || alarms[i].time < next->time))
+      next = &alarms[i];
+  }
+
+  uint64_t dma_time = 0, i2c_time;
+  bool dma = mock_adc_next_us(&dma_time);
+  if (mock_i2c_next_us(&i2c_time) && (!dma || i2c_time < dma_time)) {
+    dma_time = i2c_time;
+    dma = true;
+  }
+  if (dma && (!next || dma_time < next->time)) {
+    mock_advance_us(dma_time > now_us ? dma_time - now_us : 0);
+    return;
+  }
+
+  if (next && next->time > now_us)
+    mock_advance_us(next->time - now_us);
+  else if (next)
+    mock_fire_next_alarm(now_us);
+}
+
+// ---------------------------------------------------------------- PWM
+
+static struct {
+  uint8_t divider;
+  uint16_t wrap;
+  uint16_t level[2];
+  bool enabled;
+} pwm_slices[NUM_PWM_SLICES];
+
+void pwm_set_clkdiv_int_frac(uint slice_num, uint8_t integer, uint8_t fract) {
+  (void)fract;
+  pwm_slices[slice_num].divider = integer;
+}
+
+void pwm_set_wrap(uint slice_num, uint16_t wrap) {
+  pwm_slices[slice_num].wrap = wrap;
+}
+
+void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level) {
+  pwm_slices[slice_num].level[chan] = level;
+}
+
+void pwm_set_enabled(uint slice_num, bool enabled) {
+  pwm_slices[slice_num].enabled = enabled;
+}
+
+uint32_t mock_pwm_frequency(uint slice_num) {
+  uint32_t divider = pwm_slices[slice_num].divider ? pwm_slices[slice_num].divider : 1;
+  return clock_get_hz(clk_sys) / (divider * (pwm_slices[slice_num].wrap + 1u));
+}
+
+uint16_t mock_pwm_level(uint slice_num, uint chan) {
+  return pwm_slices[slice_num].enabled ? pwm_slices[slice_num].level[chan] : 0;
+}
+
+// ---------------------------------------------------------------- GPIO
+
+void gpio_init(uint gpio) {
+  gpio_state[gpio] = false;
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+  (void)gpio;
+  (void)out;
+}
+
+void gpio_put(uint gpio, bool value) {
+  mock_stats.gpio_puts++;
+  gpio_state[gpio] = value;
+}
+
+bool gpio_get(uint gpio) {
+  return gpio_state[gpio];
+}
+
+void gpio_pull_up(uint gpio) {
+  gpio_state[gpio] = true;
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+  (void)gpio;
+  (void)fn;
+}
+
+// Bordas habilitadas por pino e o callback único do núcleo, como no SDK
+static uint32_t gpio_irq_events[NUM_BANK0_GPIOS];
+static gpio_irq_callback_t gpio_irq_callback;
+
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled) {
+  if (enabled)
+    gpio_irq_events[gpio] |= events;
+  else
+    gpio_irq_events[gpio] &= ~events;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback) {
+  gpio_irq_callback = callback;
+  gpio_set_irq_enabled(gpio, events, enabled);
+}
+
+void mock_gpio_input(uint gpio, bool value) {
+  if (gpio_state[gpio] == value)
+    return;
+  gpio_state[gpio] = value;
+
+  uint32_t edge = value ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+  if ((gpio_irq_events[gpio] & edge) && gpio_irq_callback)
+    gpio_irq_callback(gpio, edge);
+}
+
+// ---------------------------------------------------------------- clocks e IRQ
+
+uint32_t clock_get_hz(enum clock_index clk) {
+  (void)clk;
+  return 125000000;
+}
+
+static irq_handler_t irq_handlers[NUM_IRQS][4];
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority) {
+  (void)order_priority;
+  for (uint i = 0; i < 4; ++i) {
+    if (!irq_handlers[num][i]) {
+      irq_handlers[num][i] = handler;
+      return;
+    }
+  }
+}
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+  irq_handlers[num][0] = handler;
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+  (void)num;
+  (void)enabled;
+}
+
+static void mock_raise_irq(uint num) {
+  for (uint i = 0; i < 4; ++i) {
+    if (irq_handlers[num][i])
+      irq_handlers[num][i]();
+  }
+}
+
+// ---------------------------------------------------------------- I2C
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+  i2c->hw.enable = 1;
+  i2c->hw.status = I2C_IC_STATUS_TFE_BITS;
+  i2c->baudrate = baudrate;
+  return baudrate;
+}
+
+static mock_i2c_tap_t i2c_tap;
+static bool i2c_timing;
+
+void mock_set_i2c_timing(bool enabled) {
+  i2c_timing = enabled;
+}
+
+// Tempo de um byte no barramento: 8 bits de dados e o ACK
+static uint64_t mock_i2c_byte_ns(const i2c_inst_t *i2c) {
+  return 9000000000ull / (i2c->baudrate ? i2c->baudrate : 100000);
+}
+
+void mock_set_i2c_tap(mock_i2c_tap_t tap) {
+  i2c_tap = tap;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+  i2c->hw.tar = addr;
+  mock_stats.i2c_bytes += len;
+  if (i2c_tap) {
+    for (size_t i = 0; i < len; ++i)
+      i2c_tap(i2c->index, addr, src[i], !nostop && i == len - 1);
+  }
+  if (!nostop)
+    mock_stats.i2c_transactions++;
+  return (int)len;
+}
+
+// Palavra escrita em IC_DATA_CMD (pelo DMA): byte nos bits 7..0 e STOP no bit 9.
+// O STOP é sinalizado na hora, como se o byte já tivesse saído no barramento
+static void mock_i2c_data_cmd(i2c_inst_t *i2c, uint32_t word) {
+  mock_stats.i2c_bytes++;
+  if (i2c_tap)
+    i2c_tap(i2c->index, (uint8_t)i2c->hw.tar, (uint8_t)word, word & I2C_IC_DATA_CMD_STOP_BITS);
+  if (word & I2C_IC_DATA_CMD_STOP_BITS) {
+    mock_stats.i2c_transactions++;
+    i2c->hw.raw_intr_stat |= I2C_IC_RAW_INTR_STAT_STOP_DET_BITS;
+    if (i2c->hw.intr_mask & I2C_IC_INTR_MASK_M_STOP_DET_BITS)
+      mock_raise_irq(I2C0_IRQ + i2c->index);
+  }
+}
+
+// ---------------------------------------------------------------- PIO
+
+uint pio_add_program(PIO pio, const struct pio_program *program) {
+  (void)pio;
+  (void)program;
+  return 0;
+}
+
+int pio_claim_unused_sm(PIO pio, bool required) {
+  (void)pio;
+  (void)required;
+  return 0;
+}
+
+void pio_gpio_init(PIO pio, uint pin) {
+  (void)pio;
+  (void)pin;
+}
+
+void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out) {
+  (void)pio;
+  (void)sm;
+  (void)pin_base;
+  (void)pin_count;
+  (void)is_out;
+}
+
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config) {
+  (void)pio;
+  (void)sm;
+  (void)initial_pc;
+  (void)config;
+}
+
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled) {
+  (void)pio;
+  (void)sm;
+  (void)enabled;
+}
+
+bool pio_sm_is_tx_fifo_full(PIO pio, uint sm) {
+  (void)pio;
+  (void)sm;
+  return false;
+}
+
+static mock_pio_tap_t pio_tap;
+
+void mock_set_pio_tap(mock_pio_tap_t tap) {
+  pio_tap = tap;
+}
+
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data) {
+  pio->txf[sm] = data;
+  mock_stats.pio_words++;
+  if (pio_tap)
+    pio_tap(pio->index, sm, data);
+}
+
+// ---------------------------------------------------------------- ADC
+
+adc_hw_t mock_adc_hw;
+
+static struct {
+  bool running;
+  uint round_robin;
+  float clkdiv;
+  uint64_t next_ns;  // instante da próxima conversão
+} adc_state;
+
+static void mock_dma_dreq(uint dreq, uint32_t word);
+
+void adc_init(void) {
+  adc_state.running = false;
+  adc_state.round_robin = 0;
+  adc_state.clkdiv = 0;
+}
+
+void adc_gpio_init(uint gpio) {
+  (void)gpio;
+}
+
+void adc_select_input(uint input) {
+  adc_input = input;
+}
+
+uint16_t adc_read(void) {
+  mock_stats.adc_reads++;
+  return adc_value[adc_input];
+}
+
+void adc_set_round_robin(uint input_mask) {
+  adc_state.round_robin = input_mask;
+}
+
+void adc_set_temp_sensor_enabled(bool enable) {
+  (void)enable;
+}
+
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift) {
+  (void)en;
+  (void)dreq_en;
+  (void)dreq_thresh;
+  (void)err_in_fifo;
+  (void)byte_shift;
+}
+
+void adc_set_clkdiv(float clkdiv) {
+  adc_state.clkdiv = clkdiv;
+}
+
+void adc_run(bool run) {
+  adc_state.running = run;
+  adc_state.next_ns = now_us * 1000;
+}
+
+void adc_fifo_drain(void) {
+}
+
+// Período de conversão: (1 + div) ciclos de 48 MHz, no mínimo 96
+static uint64_t mock_adc_period_ns(void) {
+  float cycles = 1.0f + adc_state.clkdiv;
+  if (cycles < 96.0f)
+    cycles = 96.0f;
+  return (uint64_t)(cycles * 1000.0f / 48.0f);
+}
+
+// Gera as conversões do modo livre ocorridas desde a última chamada
+static void mock_adc_pump(void) {
+  if (!adc_state.running)
+    return;
+
+  uint64_t period_ns = mock_adc_period_ns();
+
+  // Cada conversão acontece no próprio instante: as interrupções geradas veem a hora certa
+  uint64_t end_us = now_us;
+  while (adc_state.next_ns + period_ns <= end_us * 1000) {
+    adc_state.next_ns += period_ns;
+    now_us = adc_state.next_ns / 1000;
+    mock_adc_hw.fifo = adc_value[adc_input];
+    mock_stats.adc_reads++;
+
+    // Próxima entrada habilitada no round-robin
+    if (adc_state.round_robin) {
+      do {
+        adc_input = (adc_input + 1) % 5;
+      } while (!(adc_state.round_robin & (1u << adc_input)));
+    }
+
+    mock_dma_dreq(DREQ_ADC, mock_adc_hw.fifo);
+  }
+  now_us = end_us;
+}
+
+// ---------------------------------------------------------------- DMA
+
+typedef struct {
+  bool claimed;
+  bool busy;
+  dma_channel_config config;
+  volatile uint8_t *write_addr;
+  const volatile uint8_t *read_addr;
+  uint32_t trans_count;
+  uint32_t remaining;
+  bool irq_enabled[2];
+  bool irq_status[2];
+  i2c_inst_t *i2c;   // com mock_set_i2c_timing, o I2C que o canal alimenta no ritmo do barramento
+  uint64_t next_ns;  // instante em que a próxima palavra sai no barramento
+} mock_dma_channel_t;
+
+static mock_dma_channel_t dma_channels[NUM_DMA_CHANNELS];
+
+int dma_claim_unused_channel(bool required) {
+  for (int i = 0; i < NUM_DMA_CHANNELS; ++i) {
+    if (!dma_channels[i].claimed) {
+      dma_channels[i].claimed = true;
+      return i;
+    }
+  }
+  return required ? 0 : -1;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+  dma_channel_config c = {DMA_SIZE_32, true, false, DREQ_FORCE, channel, 0, false};
+  return c;
+}
+
+static uint32_t mock_dma_read(const volatile void *addr, enum dma_channel_transfer_size size) {
+  switch (size) {
+    case DMA_SIZE_8: return *(const volatile uint8_t *)addr;
+    case DMA_SIZE_16: return *(const volatile uint16_t *)addr;
+    default: return *(const volatile uint32_t *)addr;
+  }
+}
+
+static void mock_dma_write(volatile void *addr, enum dma_channel_transfer_size size, uint32_t word) {
+  switch (size) {
+    case DMA_SIZE_8: *(volatile uint8_t *)addr = (uint8_t)word; break;
+    case DMA_SIZE_16: *(volatile uint16_t *)addr = (uint16_t)word; break;
+    default: *(volatile uint32_t *)addr = word; break;
+  }
+}
+
+static void mock_dma_start(uint channel);
+
+// Fim de transferência: sinaliza as interrupções habilitadas e dispara o canal encadeado
+static void mock_dma_complete(uint channel) {
+  mock_dma_channel_t *ch = &dma_channels[channel];
+  ch->busy = false;
+
+  for (uint irq = 0; irq < 2; ++irq) {
+    if (ch->irq_enabled[irq]) {
+      ch->irq_status[irq] = true;
+      mock_raise_irq(irq ? DMA_IRQ_1 : DMA_IRQ_0);
+    }
+  }
+
+  if (ch->config.chain_to != channel)
+    mock_dma_start(ch->config.chain_to);
+}
+
+// Transfere uma palavra para o destino do canal, repassando escritas em FIFOs de periféricos
+static void mock_dma_step(uint channel, uint32_t word) {
+  mock_dma_channel_t *ch = &dma_channels[channel];
+  uint step = 1u << ch->config.size;
+
+  if (ch->write_addr == (volatile uint8_t *)&i2c0_inst.hw.data_cmd)
+    mock_i2c_data_cmd(&i2c0_inst, word);
+  else if (ch->write_addr == (volatile uint8_t *)&i2c1_inst.hw.data_cmd)
+    mock_i2c_data_cmd(&i2c1_inst, word);
+  else if (ch->write_addr >= (volatile uint8_t *)pio0_hw.txf && ch->write_addr < (volatile uint8_t *)(pio0_hw.txf + 4)) {
+    mock_stats.pio_words++;
+    if (pio_tap)
+      pio_tap(0, (uint)((volatile uint32_t *)ch->write_addr - pio0_hw.txf), word);
+  }
+  else
+    mock_dma_write(ch->write_addr, ch->config.size, word);
+
+  if (ch->config.read_increment)
+    ch->read_addr += step;
+  if (ch->config.write_increment)
+    ch->write_addr += step;
+
+  if (--ch->remaining == 0)
+    mock_dma_complete(channel);
+}
+
+// I2C alimentado pelo canal (escrita em IC_DATA_CMD), ou NULL
+static i2c_inst_t *mock_dma_i2c(const mock_dma_channel_t *ch) {
+  if (ch->write_addr == (volatile uint8_t *)&i2c0_inst.hw.data_cmd)
+    return &i2c0_inst;
+  if (ch->write_addr == (volatile uint8_t *)&i2c1_inst.hw.data_cmd)
+    return &i2c1_inst;
+  return NULL;
+}
+
+// Canais ligados ao ADC esperam as conversões e, com mock_set_i2c_timing, os ligados ao I2C
+// seguem o ritmo do barramento; os demais terminam na hora
+static void mock_dma_start(uint channel) {
+  mock_dma_channel_t *ch = &dma_channels[channel];
+
+  mock_stats.dma_transfers++;
+  ch->remaining = ch->trans_count;
+  ch->busy = ch->remaining > 0;
+  ch->i2c = NULL;
+  if (!ch->busy || ch->config.dreq == DREQ_ADC)
+    return;
+
+  if (i2c_timing && (ch->i2c = mock_dma_i2c(ch))) {
+    ch->i2c->hw.status = I2C_IC_STATUS_MST_ACTIVITY_BITS;
+    ch->next_ns = now_us * 1000 + mock_i2c_byte_ns(ch->i2c);
+    return;
+  }
+
+  while (ch->busy)
+    mock_dma_step(channel, mock_dma_read(ch->read_addr, ch->config.size));
+}
+
+// Instante (arredondado para cima) em que o canal de DMA do ADC em andamento termina o bloco
+static bool mock_adc_next_us(uint64_t *time) {
+  if (!adc_state.running)
+    return false;
+  for (uint channel = 0; channel < NUM_DMA_CHANNELS; ++channel) {
+    mock_dma_channel_t *ch = &dma_channels[channel];
+    if (ch->busy && ch->config.dreq == DREQ_ADC && ch->irq_enabled[1]) {
+      *time = (adc_state.next_ns + ch->remaining * mock_adc_period_ns() + 999) / 1000;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Canal do I2C em andamento cuja próxima palavra sai primeiro, ou NULL
+static mock_dma_channel_t *mock_i2c_next_channel(void) {
+  mock_dma_channel_t *next = NULL;
+  for (uint channel = 0; channel < NUM_DMA_CHANNELS; ++channel) {
+    mock_dma_channel_t *ch = &dma_channels[channel];
+    if (ch->busy && ch->i2c && (!next || ch->next_ns < next->next_ns))
+      next = ch;
+  }
+  return next;
+}
+
+// Instante (arredondado para cima) em que o quadro em andamento no I2C termina
+static bool mock_i2c_next_us(uint64_t *time) {
+  mock_dma_channel_t *ch = mock_i2c_next_channel();
+  if (!ch)
+    return false;
+  *time = (ch->next_ns + (ch->remaining - 1) * mock_i2c_byte_ns(ch->i2c) + 999) / 1000;
+  return true;
+}
+
+// Entrega ao barramento as palavras cujo tempo já passou, cada uma no próprio instante. Antes da
+// última o controlador fica ocioso, para a interrupção de fim do DMA já ver o barramento livre
+static void mock_i2c_pump(void) {
+  uint64_t end_us = now_us;
+  mock_dma_channel_t *ch;
+  while ((ch = mock_i2c_next_channel()) && ch->next_ns <= end_us * 1000) {
+    now_us = ch->next_ns / 1000;
+    ch->next_ns += mock_i2c_byte_ns(ch->i2c);
+    if (ch->remaining == 1)
+      ch->i2c->hw.status = I2C_IC_STATUS_TFE_BITS;
+    mock_dma_step((uint)(ch - dma_channels), mock_dma_read(ch->read_addr, ch->config.size));
+  }
+  now_us = end_us;
+}
+
+static void mock_dma_dreq(uint dreq, uint32_t word) {
+  for (uint channel = 0; channel < NUM_DMA_CHANNELS; ++channel) {
+    if (dma_channels[channel].busy && dma_channels[channel].config.dreq == dreq) {
+      mock_dma_step(channel, word);
+      return;
+    }
+  }
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger) {
+  dma_channels[channel].config = *config;
+  dma_channels[channel].write_addr = write_addr;
+  dma_channels[channel].read_addr = read_addr;
+  dma_channels[channel].trans_count = transfer_count;
+  if (trigger)
+    mock_dma_start(channel);
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count) {
+  dma_channels[channel].read_addr = read_addr;
+  dma_channels[channel].trans_count = transfer_count;
+  mock_dma_start(channel);
+}
+
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger) {
+  dma_channels[channel].read_addr = read_addr;
+  if (trigger)
+    mock_dma_start(channel);
+}
+
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger) {
+  dma_channels[channel].write_addr = write_addr;
+  if (trigger)
+    mock_dma_start(channel);
+}
+
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger) {
+  dma_channels[channel].trans_count = trans_count;
+  if (trigger)
+    mock_dma_start(channel);
+}
+
+void dma_channel_start(uint channel) {
+  mock_dma_start(channel);
+}
+
+void dma_channel_abort(uint channel) {
+  dma_channels[channel].busy = false;
+  if (dma_channels[channel].i2c)
+    dma_channels[channel].i2c->hw.status = I2C_IC_STATUS_TFE_BITS;
+}
+
+bool dma_channel_is_busy(uint channel) {
+  return dma_channels[channel].busy;
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel) {
+  // Só os canais do ADC ficam ocupados; esperar por eles travaria o host
+  (void)channel;
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled) {
+  dma_channels[channel].irq_enabled[0] = enabled;
+}
+
+bool dma_channel_get_irq0_status(uint channel) {
+  return dma_channels[channel].irq_status[0];
+}
+
+void dma_channel_acknowledge_irq0(uint channel) {
+  dma_channels[channel].irq_status[0] = false;
+}
+
+void dma_channel_set_irq1_enabled(uint channel, bool enabled) {
+  dma_channels[channel].irq_enabled[1] = enabled;
+}
+
+bool dma_channel_get_irq1_status(uint channel) {
+  return dma_channels[channel].irq_status[1];
+}
+
+void dma_channel_acknowledge_irq1(uint channel) {
+  dma_channels[channel].irq_status[1] = false;
+}
@@ -0,0 +1,428 @@
+/*
+Simulador do firmware no host, dirigido por um roteiro de entradas.
+O firmware inteiro (tarefas, escalonador, drivers) roda sobre o SDK simulado; o roteiro muda as
+entradas do ADC e os botões em instantes do tempo virtual, e os emuladores do SSD1306 e da matriz
+WS2812 reconstroem, a partir dos bytes do I2C e das palavras do PIO, o que apareceria na placa.
+Ao final o simulador mostra quadros por segundo, bytes e transações I2C por quadro e a latência
+da amostra até o pixel, e compara os instantâneos pedidos pelo roteiro com as imagens de referência.
+
+Roteiro em texto, uma linha por evento (tempo em ms desde o fim da inicialização):
+  <ms> adc <entrada> <valor 0-4095>
+  <ms> gpio <pino> <nível>
+  <ms> snapshot <nome>
+Linhas começando por # são comentários. Também é aceito o CSV de tools/telemetry_decode
+(sequencia,tempo_us,adc0,adc1,...), que reproduz as leituras gravadas na placa.
+
+  sense_temp_sim [-o dir] [-g dir] [-u] [-a] roteiro
+    -o dir  grava os instantâneos (PBM do display e PPM da matriz)
+    -g dir  compara os instantâneos com as referências do diretório
+    -u      com -g, regrava as referências em vez de comparar
+    -a      mostra cada instantâneo do display em texto
+*/
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mock.h"
+#include "sense_temp.h"
+#include "ssd1306_emu.h"
+#include "ws2812_emu.h"
+#include "lib/ssd1306.h"
+#include "lib/ws2812.h"
+#include "lib/adc_acq.h"
+#include "lib/scheduler.h"
+
+#define SIM_NAME_MAX 64
+// Tempo simulado depois do último evento, para as tarefas terminarem o que ele causou
+#define SIM_TAIL_MS 200
+
+typedef enum {
+  SIM_ADC,
+  SIM_GPIO,
+  SIM_SNAPSHOT,
+} sim_event_type_t;
+
+typedef struct {
+  uint64_t at_us;
+  sim_event_type_t type;
+  uint32_t target;  // entrada do ADC ou pino
+  uint32_t value;
+  char name[SIM_NAME_MAX];
+} sim_event_t;
+
+static sim_event_t *events;
+static size_t event_count, event_capacity;
+
+static ssd1306_emu_t display;
+static ws2812_emu_t leds;
+
+// Quadro do display: transações enviadas uma atrás da outra no barramento (um envio do DMA);
+// um intervalo maior que SIM_FRAME_GAP_US sem bytes começa outro quadro
+#define SIM_FRAME_GAP_US 200
+
+static struct {
+  uint32_t frames;
+  uint64_t last_byte_us;
+  uint64_t bytes;  // inclui o byte de endereço de cada transação
+  uint32_t transactions;
+} bus;
+
+// Latência da amostra até o pixel: da mudança visível mais antiga ainda não exibida na entrada
+// da temperatura até a transação que altera a GDDRAM
+static struct {
+  bool pending;
+  uint64_t since_us;
+  uint32_t count;
+  uint64_t sum_us, max_us;
+} latency;
+
+static struct {
+  const char *output_dir, *golden_dir;
+  bool update, ascii;
+} options;
+
+static uint32_t snapshots, matched, mismatched, missing;
+
+// ---------------------------------------------------------------- Observadores dos barramentos
+
+static void sim_i2c_tap(uint i2c_index, uint8_t address, uint8_t byte, bool stop) {
+  if (i2c_index != i2c_get_index(ssd.i2c_port) || address != ssd.address)
+    return;
+
+  uint64_t now = time_us_64();
+  if (!bus.frames || now - bus.last_byte_us > SIM_FRAME_GAP_US)
+    bus.frames++;
+  bus.last_byte_us = now;
+
+  bool changed = ssd1306_emu_byte(&display, byte, stop);
+  if (!stop)
+    return;
+
+  bus.transactions++;
+  if (changed && latency.pending) {
+    uint64_t elapsed = now - latency.since_us;
+    latency.count++;
+    latency.sum_us += elapsed;
+    if (elapsed > latency.max_us)
+      latency.max_us = elapsed;
+    latency.pending = false;
+  }
+}
+
+static void sim_pio_tap(uint pio_index, uint sm, uint32_t word) {
+  if (pio_index != matriz.pio->index || sm != matriz.sm)
+    return;
+  // A matriz já envia o primeiro quadro dentro de ws2812_init
+  if (!leds.count)
+    ws2812_emu_init(&leds, matriz.width, matriz.height);
+  ws2812_emu_word(&leds, word, time_us_64());
+}
+
+// ---------------------------------------------------------------- Roteiro
+
+static sim_event_t *sim_add_event(void) {
+  if (event_count == event_capacity) {
+    event_capacity = event_capacity ? 2 * event_capacity : 256;
+    events = realloc(events, event_capacity * sizeof(*events));
+    if (!events) {
+      perror("realloc");
+      exit(2);
+    }
+  }
+  sim_event_t *event = &events[event_count++];
+  memset(event, 0, sizeof(*event));
+  return event;
+}
+
+static bool sim_parse_line(char *line, unsigned number) {
+  char type[16];
+  double ms;
+  sim_event_t event = {0};
+  int used = 0;
+
+  if (sscanf(line, "%lf %15s %n", &ms, type, &used) < 2 || ms < 0)
+    goto invalid;
+  event.at_us = (uint64_t)(ms * 1000);
+  if (!strcmp(type, "adc")) {
+    event.type = SIM_ADC;
+    if (sscanf(line + used, "%u %u", &event.target, &event.value) != 2 || event.target > 4 || event.value > 4095)
+      goto invalid;
+  } else if (!strcmp(type, "gpio")) {
+    event.type = SIM_GPIO;
+    if (sscanf(line + used, "%u %u", &event.target, &event.value) != 2 || event.target >= 30 || event.value > 1)
+      goto invalid;
+  } else if (!strcmp(type, "snapshot")) {
+    event.type = SIM_SNAPSHOT;
+    if (sscanf(line + used, "%63[A-Za-z0-9_-]", event.name) != 1)
+      goto invalid;
+  } else {
+    goto invalid;
+  }
+  *sim_add_event() = event;
+  return true;
+
+invalid:
+  fprintf(stderr, "linha %u inválida: %s", number, line);
+  return false;
+}
+
+// Linha do CSV da telemetria: as leituras brutas têm os bits da sobreamostragem e viram dois
+// eventos do ADC (Y na entrada 0, X na 1) no instante do registro
+static bool sim_parse_csv(char *line, unsigned number, uint32_t *first_us, bool *started) {
+  unsigned long sequence, time_us;
+  unsigned adc0, adc1;
+  if (sscanf(line, "%lu,%lu,%u,%u", &sequence, &time_us, &adc0, &adc1) != 4) {
+    fprintf(stderr, "linha %u inválida: %s", number, line);
+    return false;
+  }
+  if (!*started) {
+    *first_us = (uint32_t)time_us;
+    *started = true;
+  }
+
+  uint shift = adc_acq_bits() - 12;
+  uint64_t at_us = (uint32_t)time_us - *first_us;
+  sim_event_t *event = sim_add_event();
+  *event = (sim_event_t){at_us, SIM_ADC, 0, adc0 >> shift, ""};
+  event = sim_add_event();
+  *event = (sim_event_t){at_us, SIM_ADC, 1, adc1 >> shift, ""};
+  return true;
+}
+
+static bool sim_load(const char *path) {
+  FILE *file = fopen(path, "r");
+  if (!file) {
+    fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    return false;
+  }
+
+  char line[256];
+  unsigned number = 0;
+  bool ok = true, csv = false, started = false;
+  uint32_t first_us = 0;
+  while (ok && fgets(line, sizeof(line), file)) {
+    number++;
+    char *p = line + strspn(line, " \t");
+    if (*p == '#' || *p == '\n' || *p == '\r' || !*p)
+      continue;
+    if (number == 1 && !strncmp(p, "sequencia,", 10)) {
+      csv = true;
+      continue;
+    }
+    ok = csv ? sim_parse_csv(p, number, &first_us, &started) : sim_parse_line(p, number);
+  }
+  fclose(file);
+
+  // Os eventos são aplicados na ordem do arquivo, então o tempo não pode voltar
+  for (size_t i = 1; i < event_count && ok; ++i) {
+    if (events[i].at_us < events[i - 1].at_us) {
+      fprintf(stderr, "%s: eventos fora de ordem (%.1f ms depois de %.1f ms)\n", path,
+              events[i].at_us / 1e3, events[i - 1].at_us / 1e3);
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+// ---------------------------------------------------------------- Instantâneos
+
+// Imagem do display em PBM binário (P4): linhas de bits, o mais significativo à esquerda, e 1 é
+// preto; os pixels acesos aparecem brancos
+static size_t sim_encode_pbm(uint8_t *out) {
+  uint8_t height = ssd1306_emu_height(&display);
+  size_t size = sprintf((char *)out, "P4\n%d %d\n", SSD1306_EMU_WIDTH, height);
+  for (uint8_t y = 0; y < height; ++y) {
+    for (uint8_t x = 0; x < SSD1306_EMU_WIDTH; x += 8) {
+      uint8_t bits = 0;
+      for (uint8_t bit = 0; bit < 8; ++bit)
+        bits |= !ssd1306_emu_pixel(&display, x + bit, y) << (7 - bit);
+      out[size++] = bits;
+    }
+  }
+  return size;
+}
+
+// Matriz em PPM binário (P6), um pixel por LED
+static size_t sim_encode_ppm(uint8_t *out) {
+  size_t size = sprintf((char *)out, "P6\n%d %d\n255\n", leds.width, leds.height);
+  for (uint8_t y = 0; y < leds.height; ++y) {
+    for (uint8_t x = 0; x < leds.width; ++x) {
+      uint32_t rgb = ws2812_emu_pixel(&leds, x, y);
+      out[size++] = rgb >> 16;
+      out[size++] = rgb >> 8;
+      out[size++] = rgb;
+    }
+  }
+  return size;
+}
+
+static bool sim_write(const char *dir, const char *name, const char *extension, const uint8_t *data, size_t size) {
+  char path[512];
+  snprintf(path, sizeof(path), "%s/%s.%s", dir, name, extension);
+  FILE *file = fopen(path, "wb");
+  if (!file || fwrite(data, 1, size, file) != size) {
+    fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    if (file)
+      fclose(file);
+    return false;
+  }
+  fclose(file);
+  return true;
+}
+
+// Compara com a referência; a diferença é contada em bytes da imagem
+static void sim_compare(const char *name, const char *extension, const uint8_t *data, size_t size) {
+  char path[512];
+  snprintf(path, sizeof(path), "%s/%s.%s", options.golden_dir, name, extension);
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    printf("  %s.%s: sem referência\n", name, extension);
+    missing++;
+    return;
+  }
+
+  static uint8_t golden[4096];
+  size_t golden_size = fread(golden, 1, sizeof(golden), file);
+  fclose(file);
+
+  size_t differences = golden_size > size ? golden_size - size : size - golden_size;
+  for (size_t i = 0; i < size && i < golden_size; ++i)
+    differences += golden[i] != data[i];
+  if (differences) {
+    printf("  %s.%s: DIFERENTE da referência (%zu bytes)\n", name, extension, differences);
+    mismatched++;
+  } else {
+    matched++;
+  }
+}
+
+static void sim_print_ascii(const char *name) {
+  printf("  %s:\n", name);
+  for (uint8_t y = 0; y < ssd1306_emu_height(&display); ++y) {
+    printf("  |");
+    for (uint8_t x = 0; x < SSD1306_EMU_WIDTH; ++x)
+      putchar(ssd1306_emu_pixel(&display, x, y) ? '#' : ' ');
+    printf("|\n");
+  }
+}
+
+static void sim_snapshot(const char *name) {
+  static uint8_t pbm[32 + SSD1306_EMU_WIDTH / 8 * 64], ppm[32 + 3 * WS2812_EMU_MAX_LEDS];
+  size_t pbm_size = sim_encode_pbm(pbm), ppm_size = sim_encode_ppm(ppm);
+  char matrix_name[SIM_NAME_MAX + 8];
+  snprintf(matrix_name, sizeof(matrix_name), "%s_matriz", name);
+  snapshots++;
+
+  if (options.ascii)
+    sim_print_ascii(name);
+  if (options.output_dir) {
+    sim_write(options.output_dir, name, "pbm", pbm, pbm_size);
+    sim_write(options.output_dir, matrix_name, "ppm", ppm, ppm_size);
+  }
+  if (options.golden_dir && options.update) {
+    sim_write(options.golden_dir, name, "pbm", pbm, pbm_size);
+    sim_write(options.golden_dir, matrix_name, "ppm", ppm, ppm_size);
+  } else if (options.golden_dir) {
+    sim_compare(name, "pbm", pbm, pbm_size);
+    sim_compare(matrix_name, "ppm", ppm, ppm_size);
+  }
+}
+
+// ---------------------------------------------------------------- Execução
+
+// Temperatura exibida (graus inteiros) para uma leitura da entrada do joystick
+static inline int sim_degrees(uint32_t raw) {
+  return (int)(raw * 50 / 4095);
+}
+
+static void sim_apply(const sim_event_t *event, uint32_t *adc) {
+  switch (event->type) {
+    case SIM_ADC:
+      // Só uma mudança que altera o número na tela abre a medição da latência
+      if (event->target == 0 && sim_degrees(event->value) != sim_degrees(adc[0]) && !latency.pending) {
+        latency.pending = true;
+        latency.since_us = time_us_64();
+      }
+      adc[event->target] = event->value;
+      mock_set_adc(event->target, (uint16_t)event->value);
+      break;
+    case SIM_GPIO:
+      mock_gpio_input(event->target, event->value);
+      break;
+    case SIM_SNAPSHOT:
+      sim_snapshot(event->name);
+      break;
+  }
+}
+
+static void sim_usage(const char *program) {
+  fprintf(stderr, "uso: %s [-o dir] [-g dir] [-u] [-a] roteiro\n", program);
+}
+
+int main(int argc, char **argv) {
+  int option;
+  while ((option = getopt(argc, argv, "o:g:ua")) != -1) {
+    switch (option) {
+      case 'o': options.output_dir = optarg; break;
+      case 'g': options.golden_dir = optarg; break;
+      case 'u': options.update = true; break;
+      case 'a': options.ascii = true; break;
+      default: sim_usage(argv[0]); return 2;
+    }
+  }
+  if (optind != argc - 1 || (options.update && !options.golden_dir)) {
+    sim_usage(argv[0]);
+    return 2;
+  }
+
+  // Os botões têm pull-up: começam soltos
+  mock_gpio_input(5, 1);
+  mock_gpio_input(6, 1);
+
+  ssd1306_emu_init(&display);
+  mock_set_i2c_tap(sim_i2c_tap);
+  // O envio de um quadro leva o tempo do barramento: a tela vê o DMA ocupado como na placa
+  mock_set_i2c_timing(true);
+  mock_set_pio_tap(sim_pio_tap);
+  inicializa();
+  if (!leds.count)
+    ws2812_emu_init(&leds, matriz.width, matriz.height);
+
+  if (!sim_load(argv[optind]))
+    return 2;
+
+  // A partida (configuração e primeiro quadro) não entra nas medidas
+  memset(&bus, 0, sizeof(bus));
+  uint32_t display_bytes = display.bytes;
+  uint32_t adc[5] = {0};
+  uint64_t start_us = time_us_64();
+  for (size_t i = 0; i < event_count; ++i) {
+    uint64_t target = start_us + events[i].at_us;
+    if (target > time_us_64())
+      scheduler_run_until(target);
+    sim_apply(&events[i], adc);
+  }
+  scheduler_run_until(delayed_by_ms(get_absolute_time(), SIM_TAIL_MS));
+
+  double seconds = (time_us_64() - start_us) / 1e6;
+  uint64_t bytes = display.bytes - display_bytes + bus.transactions;  // mais o endereço de cada transação
+  printf("%s: %zu eventos, %.2f s simulados\n", argv[optind], event_count, seconds);
+  printf("display: %u quadros (%.1f por s), %.1f bytes e %.2f transações I2C por quadro, %u comandos desconhecidos\n",
+         bus.frames, bus.frames / seconds, bus.frames ? (double)bytes / bus.frames : 0.0,
+         bus.frames ? (double)bus.transactions / bus.frames : 0.0, display.unknown_commands);
+  printf("latência amostra-pixel: %u mudanças, média %.1f ms, máx %.1f ms%s\n", latency.count,
+         latency.count ? latency.sum_us / 1e3 / latency.count : 0.0, latency.max_us / 1e3,
+         latency.pending ? " (uma mudança não chegou à tela)" : "");
+  printf("matriz: %u quadros, %u palavras PIO\n", leds.frames, leds.words);
+  if (options.golden_dir && !options.update)
+    printf("instantâneos: %u, %u imagens iguais às referências, %u diferentes, %u sem referência\n",
+           snapshots, matched, mismatched, missing);
+  else
+    printf("instantâneos: %u\n", snapshots);
+
+  free(events);
+  return mismatched || missing ? 1 : 0;
+}
@@ -0,0 +1,190 @@
+/*
+Implementação do emulador do SSD1306.
+Cada transação começa por um byte de controle: com Co = 0 todos os bytes seguintes são comandos
+(D/C = 0) ou dados (D/C = 1); com Co = 1 só o próximo byte é, e outro byte de controle vem
+depois. Os comandos com parâmetros são acumulados até o último chegar.
+*/
+
+#include <string.h>
+#include "ssd1306_emu.h"
+
+// Estado logo depois do reset, segundo a folha de dados
+void ssd1306_emu_init(ssd1306_emu_t *emu) {
+  memset(emu, 0, sizeof(*emu));
+  emu->mux = 63;
+  emu->contrast = 0x7F;
+  emu->addressing = 2;
+  emu->col_end = SSD1306_EMU_WIDTH - 1;
+  emu->page_end = SSD1306_EMU_PAGES - 1;
+}
+
+// Quantos parâmetros seguem o comando
+static uint8_t ssd1306_emu_params(uint8_t command) {
+  switch (command) {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+      return 1;
+    case 0x21: case 0x22: case 0xA3:
+      return 2;
+    case 0x29: case 0x2A:
+      return 5;
+    case 0x26: case 0x27:
+      return 6;
+    case 0x2C: case 0x2D:
+      return 7;
+    default:
+      return 0;
+  }
+}
+
+// Rolagem de conteúdo de uma coluna nas páginas p0..p1, entre as colunas x0..x1: a coluna que
+// sai por um lado entra pelo outro
+static void ssd1306_emu_content_scroll(ssd1306_emu_t *emu, bool left, uint8_t p0, uint8_t p1, uint8_t x0, uint8_t x1) {
+  if (x1 >= SSD1306_EMU_WIDTH || x0 >= x1 || p1 >= SSD1306_EMU_PAGES || p0 > p1)
+    return;
+
+  for (uint8_t page = p0; page <= p1; ++page) {
+    uint8_t *row = emu->gddram[page];
+    if (left) {
+      uint8_t first = row[x0];
+      memmove(&row[x0], &row[x0 + 1], x1 - x0);
+      row[x1] = first;
+    } else {
+      uint8_t last = row[x1];
+      memmove(&row[x0 + 1], &row[x0], x1 - x0);
+      row[x0] = last;
+    }
+  }
+  emu->changed = true;
+}
+
+static void ssd1306_emu_execute(ssd1306_emu_t *emu) {
+  const uint8_t *c = emu->command;
+  emu->commands++;
+
+  if (c[0] <= 0x0F) {
+    emu->col = (emu->col & 0xF0) | (c[0] & 0x0F);
+  } else if (c[0] >= 0x10 && c[0] <= 0x1F) {
+    emu->col = (emu->col & 0x0F) | (c[0] & 0x0F) << 4;
+  } else if (c[0] >= 0xB0 && c[0] <= 0xB7) {
+    emu->page = c[0] & 0x07;
+  } else if (c[0] >= 0x40 && c[0] <= 0x7F) {
+    // Linha inicial: o driver sempre usa 0
+  } else {
+    switch (c[0]) {
+      case 0x20: emu->addressing = c[1] & 0x03; break;
+      case 0x21:
+        emu->col_start = emu->col = c[1] & 0x7F;
+        emu->col_end = c[2] & 0x7F;
+        break;
+      case 0x22:
+        emu->page_start = emu->page = c[1] & 0x07;
+        emu->page_end = c[2] & 0x07;
+        break;
+      case 0x81: emu->contrast = c[1]; break;
+      case 0xA8: emu->mux = c[1] & 0x3F; break;
+      case 0xA4: case 0xA5: emu->entire_on = c[0] & 1; break;
+      case 0xA6: case 0xA7: emu->inverted = c[0] & 1; break;
+      case 0xAE: case 0xAF: emu->display_on = c[0] & 1; break;
+      case 0x2C: ssd1306_emu_content_scroll(emu, false, c[2] & 0x07, c[4] & 0x07, c[6], c[7]); break;
+      case 0x2D: ssd1306_emu_content_scroll(emu, true, c[2] & 0x07, c[4] & 0x07, c[6], c[7]); break;
+      // Aceitos sem efeito na imagem: remapeamentos, temporização, bomba de carga e rolagem contínua
+      case 0x26: case 0x27: case 0x29: case 0x2A: case 0x2E: case 0x2F: case 0x8D: case 0xA0: case 0xA1:
+      case 0xA3: case 0xC0: case 0xC8: case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB: case 0xE3:
+        break;
+      default:
+        emu->unknown_commands++;
+        break;
+    }
+  }
+}
+
+static void ssd1306_emu_command_byte(ssd1306_emu_t *emu, uint8_t byte) {
+  if (!emu->command_len)
+    emu->command_need = 1 + ssd1306_emu_params(byte);
+  emu->command[emu->command_len++] = byte;
+  if (emu->command_len == emu->command_need) {
+    ssd1306_emu_execute(emu);
+    emu->command_len = 0;
+  }
+}
+
+// Grava um byte na posição atual e avança conforme o modo de endereçamento
+static void ssd1306_emu_data_byte(ssd1306_emu_t *emu, uint8_t byte) {
+  emu->data_bytes++;
+  if (emu->col < SSD1306_EMU_WIDTH && emu->page < SSD1306_EMU_PAGES && emu->gddram[emu->page][emu->col] != byte) {
+    emu->gddram[emu->page][emu->col] = byte;
+    emu->changed = true;
+  }
+
+  if (emu->addressing == 0) {
+    // Horizontal: colunas da janela, depois a próxima página
+    if (emu->col++ >= emu->col_end) {
+      emu->col = emu->col_start;
+      emu->page = emu->page >= emu->page_end ? emu->page_start : emu->page + 1;
+    }
+  } else if (emu->addressing == 1) {
+    // Vertical: páginas da janela, depois a próxima coluna
+    if (emu->page++ >= emu->page_end) {
+      emu->page = emu->page_start;
+      emu->col = emu->col >= emu->col_end ? emu->col_start : emu->col + 1;
+    }
+  } else {
+    // Página: só a coluna avança, voltando ao início no fim da linha
+    emu->col = emu->col >= SSD1306_EMU_WIDTH - 1 ? 0 : emu->col + 1;
+  }
+}
+
+// Processa um byte do barramento. Retorna true quando ele encerra uma transação que alterou
+// a GDDRAM: é quando a imagem nova passa a valer no painel
+bool ssd1306_emu_byte(ssd1306_emu_t *emu, uint8_t byte, bool stop) {
+  if (!emu->in_transaction) {
+    emu->in_transaction = true;
+    emu->mode = SSD1306_EMU_CONTROL;
+    emu->changed = false;
+    emu->transactions++;
+  }
+  emu->bytes++;
+
+  switch (emu->mode) {
+    case SSD1306_EMU_CONTROL:
+      if (byte & 0x80)
+        emu->mode = byte & 0x40 ? SSD1306_EMU_ONE_DATA : SSD1306_EMU_ONE_COMMAND;
+      else
+        emu->mode = byte & 0x40 ? SSD1306_EMU_DATA : SSD1306_EMU_COMMANDS;
+      break;
+    case SSD1306_EMU_COMMANDS:
+      ssd1306_emu_command_byte(emu, byte);
+      break;
+    case SSD1306_EMU_DATA:
+      ssd1306_emu_data_byte(emu, byte);
+      break;
+    case SSD1306_EMU_ONE_COMMAND:
+      ssd1306_emu_command_byte(emu, byte);
+      emu->mode = SSD1306_EMU_CONTROL;
+      break;
+    case SSD1306_EMU_ONE_DATA:
+      ssd1306_emu_data_byte(emu, byte);
+      emu->mode = SSD1306_EMU_CONTROL;
+      break;
+  }
+
+  if (!stop)
+    return false;
+  emu->in_transaction = false;
+  return emu->changed;
+}
+
+// Linhas exibidas, pela razão de multiplexação
+uint8_t ssd1306_emu_height(const ssd1306_emu_t *emu) {
+  return emu->mux + 1;
+}
+
+// Pixel como aparece no painel
+bool ssd1306_emu_pixel(const ssd1306_emu_t *emu, uint8_t x, uint8_t y) {
+  if (!emu->display_on || x >= SSD1306_EMU_WIDTH || y >= ssd1306_emu_height(emu))
+    return false;
+  if (emu->entire_on)
+    return true;
+  bool on = emu->gddram[y >> 3][x] >> (y & 0x07) & 1;
+  return on != emu->inverted;
+}
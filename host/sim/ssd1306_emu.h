@@ -0,0 +1,49 @@
+/*
+Emulador do controlador SSD1306 para o simulador do host.
+Recebe os bytes do barramento I2C endereçados ao painel, separa byte de controle, comandos e
+dados como o controlador real e mantém a GDDRAM. A imagem visível leva em conta display
+desligado, tudo aceso e inversão; com o remapeamento usado pelo driver (A1/C8) as coordenadas
+da GDDRAM são as mesmas do desenho.
+*/
+
+#ifndef SSD1306_EMU_H
+#define SSD1306_EMU_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SSD1306_EMU_WIDTH 128
+#define SSD1306_EMU_PAGES 8
+
+typedef enum {
+  SSD1306_EMU_CONTROL,       // esperando o byte de controle
+  SSD1306_EMU_COMMANDS,      // Co = 0, D/C = 0: o resto da transação são comandos
+  SSD1306_EMU_DATA,          // Co = 0, D/C = 1: o resto da transação são dados
+  SSD1306_EMU_ONE_COMMAND,   // Co = 1: um comando e depois outro byte de controle
+  SSD1306_EMU_ONE_DATA,      // Co = 1: um dado e depois outro byte de controle
+} ssd1306_emu_mode_t;
+
+typedef struct {
+  // Estado do controlador
+  uint8_t gddram[SSD1306_EMU_PAGES][SSD1306_EMU_WIDTH];
+  bool display_on, entire_on, inverted;
+  uint8_t mux, contrast, addressing;
+  uint8_t col, page, col_start, col_end, page_start, page_end;
+
+  // Decodificação do fluxo
+  ssd1306_emu_mode_t mode;
+  bool in_transaction;
+  uint8_t command[8];
+  uint8_t command_len, command_need;
+  bool changed;  // a transação atual alterou a GDDRAM
+
+  // Contadores
+  uint32_t transactions, bytes, commands, data_bytes, unknown_commands;
+} ssd1306_emu_t;
+
+void ssd1306_emu_init(ssd1306_emu_t *emu);
+bool ssd1306_emu_byte(ssd1306_emu_t *emu, uint8_t byte, bool stop);
+uint8_t ssd1306_emu_height(const ssd1306_emu_t *emu);
+bool ssd1306_emu_pixel(const ssd1306_emu_t *emu, uint8_t x, uint8_t y);
+
+#endif
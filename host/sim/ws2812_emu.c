@@ -0,0 +1,42 @@
+/*
+Implementação do emulador da cadeia WS2812.
+*/
+
+#include <string.h>
+#include "ws2812_emu.h"
+
+void ws2812_emu_init(ws2812_emu_t *emu, uint8_t width, uint8_t height) {
+  memset(emu, 0, sizeof(*emu));
+  emu->width = width;
+  emu->height = height;
+  emu->count = width * height <= WS2812_EMU_MAX_LEDS ? width * height : WS2812_EMU_MAX_LEDS;
+}
+
+// Processa uma palavra do FIFO. Retorna true quando ela completa um quadro (todos os LEDs
+// receberam uma cor nova)
+bool ws2812_emu_word(ws2812_emu_t *emu, uint32_t word, uint64_t now_us) {
+  if (emu->next && now_us - emu->last_us > WS2812_EMU_RESET_US)
+    emu->next = 0;
+  emu->last_us = now_us;
+  emu->words++;
+
+  // Palavras além do último LED seguiriam para fora da cadeia
+  if (emu->next >= emu->count)
+    return false;
+
+  uint8_t g = word >> 24, r = word >> 16, b = word >> 8;
+  emu->rgb[emu->next++] = (uint32_t)r << 16 | (uint32_t)g << 8 | b;
+  if (emu->next < emu->count)
+    return false;
+  emu->frames++;
+  return true;
+}
+
+// Cor do LED em (x, y), com (0, 0) no canto superior esquerdo: a cadeia percorre a matriz em
+// serpentina a partir do canto inferior direito, como em ws2812.c
+uint32_t ws2812_emu_pixel(const ws2812_emu_t *emu, uint8_t x, uint8_t y) {
+  if (x >= emu->width || y >= emu->height)
+    return 0;
+  unsigned index = y % 2 == 0 ? y * emu->width + x : y * emu->width + (emu->width - 1 - x);
+  return emu->rgb[emu->count - 1 - index];
+}
@@ -0,0 +1,30 @@
+/*
+Emulador de uma cadeia de LEDs WS2812 para o simulador do host.
+Recebe as palavras entregues ao FIFO da máquina de estados (GRB nos 24 bits altos) e monta o
+quadro como os LEDs: cada LED fica com a primeira cor que chega e repassa o resto, e uma pausa
+maior que o reset (50 us) recomeça a cadeia.
+*/
+
+#ifndef WS2812_EMU_H
+#define WS2812_EMU_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define WS2812_EMU_MAX_LEDS 256
+#define WS2812_EMU_RESET_US 50
+
+typedef struct {
+  uint8_t width, height;
+  uint16_t count;
+  uint32_t rgb[WS2812_EMU_MAX_LEDS];  // cor exibida por cada LED da cadeia (0xRRGGBB)
+  uint16_t next;                      // próximo LED a receber uma cor
+  uint64_t last_us;                   // última palavra recebida
+  uint32_t frames, words;
+} ws2812_emu_t;
+
+void ws2812_emu_init(ws2812_emu_t *emu, uint8_t width, uint8_t height);
+bool ws2812_emu_word(ws2812_emu_t *emu, uint32_t word, uint64_t now_us);
+uint32_t ws2812_emu_pixel(const ws2812_emu_t *emu, uint8_t x, uint8_t y);
+
+#endif
@@ -0,0 +1,158 @@
+/*
+Decodificador da telemetria binária do firmware (lib/telemetry.h).
+Lê o fluxo da porta serial (ou de um arquivo gravado), separa os pacotes pelo byte 0x00,
+desfaz o COBS, confere o CRC e escreve um registro por linha em CSV na saída padrão.
+Contagens de pacotes, erros e perdas vão para a saída de erro.
+Com -l, as páginas do log da flash (despejadas pelo comando 'd') vão em CSV para o arquivo indicado.
+
+  ./telemetry_decode /dev/ttyACM0 > telemetria.csv
+  ./telemetry_decode < captura.bin > telemetria.csv
+  ./telemetry_decode -l log.csv /dev/ttyACM0 > telemetria.csv
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "lib/telemetry.h"
+#include "lib/flash_log.h"
+
+#define MAX_FRAME (TELEMETRY_MAX_FRAME + TELEMETRY_MAX_FRAME / 254 + 2)
+
+static unsigned long packets, records, crc_errors, frame_errors, lost;
+static unsigned long log_pages, log_records;
+static FILE *log_output;
+
+static uint16_t get16(const uint8_t *p) {
+  return p[0] | p[1] << 8;
+}
+
+static uint32_t get32(const uint8_t *p) {
+  return get16(p) | (uint32_t)get16(p + 2) << 16;
+}
+
+// Desfaz o COBS de um quadro (sem o delimitador); retorna o tamanho ou -1 se malformado
+static int cobs_decode(const uint8_t *in, size_t len, uint8_t *out) {
+  size_t pos = 0, o = 0;
+  while (pos < len) {
+    uint8_t code = in[pos++];
+    if (!code || pos + code - 1 > len)
+      return -1;
+    for (uint8_t i = 1; i < code; ++i)
+      out[o++] = in[pos++];
+    if (code < 0xFF && pos < len)
+      out[o++] = 0;
+  }
+  return (int)o;
+}
+
+// Página do log da flash: registros conferidos um a um, os apagados são ignorados
+static void decode_log_page(const uint8_t *page) {
+  log_pages++;
+  for (size_t r = 0; r < FLASH_LOG_RECORDS_PER_PAGE; ++r) {
+    flash_log_record_t record;
+    memcpy(&record, page + r * sizeof(record), sizeof(record));
+    if (!flash_log_record_valid(&record))
+      continue;
+    log_records++;
+    if (log_output)
+      fprintf(log_output, "%lu,%d,%u\n", (unsigned long)record.number, record.value, record.flags);
+  }
+}
+
+static void decode_frame(const uint8_t *frame, size_t len) {
+  static bool have_sequence;
+  static uint16_t expected;
+  uint8_t packet[MAX_FRAME];
+
+  int n = cobs_decode(frame, len, packet);
+  if (n == 1 + FLASH_PAGE_SIZE + TELEMETRY_CRC_SIZE && packet[0] == TELEMETRY_MESSAGE_LOG_PAGE) {
+    if (telemetry_crc16(packet, n - TELEMETRY_CRC_SIZE) != get16(packet + n - TELEMETRY_CRC_SIZE))
+      crc_errors++;
+    else
+      decode_log_page(packet + 1);
+    return;
+  }
+  if (n < TELEMETRY_HEADER_SIZE + TELEMETRY_CRC_SIZE || packet[0] != TELEMETRY_VERSION) {
+    frame_errors++;
+    return;
+  }
+
+  uint8_t count = packet[3];
+  if ((size_t)n != (size_t)(TELEMETRY_HEADER_SIZE + count * TELEMETRY_RECORD_SIZE + TELEMETRY_CRC_SIZE)) {
+    frame_errors++;
+    return;
+  }
+  if (telemetry_crc16(packet, n - TELEMETRY_CRC_SIZE) != get16(packet + n - TELEMETRY_CRC_SIZE)) {
+    crc_errors++;
+    return;
+  }
+
+  // Saltos na sequência são pacotes descartados no firmware ou perdidos no caminho
+  uint16_t sequence = get16(packet + 1);
+  if (have_sequence)
+    lost += (uint16_t)(sequence - expected);
+  expected = sequence + 1;
+  have_sequence = true;
+  packets++;
+
+  uint32_t base = get32(packet + 4);
+  for (uint8_t r = 0; r < count; ++r) {
+    const uint8_t *p = packet + TELEMETRY_HEADER_SIZE + r * TELEMETRY_RECORD_SIZE;
+    printf("%u,%lu", sequence, (unsigned long)(uint32_t)(base + get16(p)));
+    for (uint8_t c = 0; c < TELEMETRY_CHANNELS; ++c)
+      printf(",%u", get16(p + 2 + 2 * c));
+    printf(",%u,%u\n", p[2 + 2 * TELEMETRY_CHANNELS] & 0x0F, p[2 + 2 * TELEMETRY_CHANNELS] >> 4);
+    records++;
+  }
+}
+
+int main(int argc, char **argv) {
+  FILE *in = stdin;
+  int arg = 1;
+  if (arg + 1 < argc && !strcmp(argv[arg], "-l")) {
+    if (!(log_output = fopen(argv[arg + 1], "w"))) {
+      perror(argv[arg + 1]);
+      return 1;
+    }
+    fprintf(log_output, "registro,decimos_grau,faixa\n");
+    arg += 2;
+  }
+  if (arg < argc && !(in = fopen(argv[arg], "rb"))) {
+    perror(argv[arg]);
+    return 1;
+  }
+
+  printf("sequencia,tempo_us");
+  for (int c = 0; c < TELEMETRY_CHANNELS; ++c)
+    printf(",adc%d", c);
+  printf(",estado,faixa\n");
+
+  // O primeiro quadro pode estar cortado se a captura começou no meio de um pacote
+  uint8_t frame[MAX_FRAME];
+  size_t len = 0;
+  bool overflow = false;
+  int c;
+  while ((c = fgetc(in)) != EOF) {
+    if (c) {
+      if (len < sizeof(frame))
+        frame[len++] = c;
+      else
+        overflow = true;
+      continue;
+    }
+    if (overflow)
+      frame_errors++;
+    else if (len)
+      decode_frame(frame, len);
+    len = 0;
+    overflow = false;
+  }
+
+  fprintf(stderr, "%lu pacotes, %lu registros, %lu erros de CRC, %lu quadros inválidos, %lu pacotes perdidos\n",
+          packets, records, crc_errors, frame_errors, lost);
+  if (log_pages)
+    fprintf(stderr, "log da flash: %lu páginas, %lu registros\n", log_pages, log_records);
+  if (log_output)
+    fclose(log_output);
+  return 0;
+}
@@ -0,0 +1,213 @@
+/*
+O arquivo adc_acq.c implementa a aquisição contínua do ADC com DMA.
+Dois canais de DMA encadeados preenchem alternadamente as duas metades do buffer; ao fim de cada
+metade a interrupção soma as amostras de cada entrada, decima e publica o resultado.
+*/
+
+#include "adc_acq.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+// Clock do ADC (48 MHz) e ciclos por conversão
+#define ADC_CLOCK_HZ 48000000u
+#define ADC_CYCLES_PER_SAMPLE 96u
+
+#define BLOCK_MAX (ADC_ACQ_MAX_INPUTS << (2 * ADC_ACQ_MAX_OVERSAMPLE_BITS))
+
+static uint16_t buffer[2][BLOCK_MAX];
+static int dma_chan[2] = {-1, -1};
+static uint block_len;
+
+static uint8_t inputs[ADC_ACQ_MAX_INPUTS];  // entradas na ordem do round-robin
+static uint8_t input_count;
+static uint8_t oversample_bits;
+
+static volatile uint32_t raw_value[ADC_ACQ_MAX_INPUTS];
+static volatile uint32_t sequence;
+static volatile uint32_t block_time_us;  // publicação do último bloco
+static adc_acq_block_callback_t block_callback;
+static volatile bool single_block;  // captura avulsa: para o ADC depois de um bloco
+
+// Filtros de bloco por entrada e o buffer onde as amostras de uma entrada são separadas
+static struct {
+  adc_acq_filter_t fn;
+  void *data;
+} filters[ADC_ACQ_MAX_INPUTS];
+static int16_t filter_samples[1 << (2 * ADC_ACQ_MAX_OVERSAMPLE_BITS)];
+
+// Soma as amostras de cada entrada no bloco e publica a média com os bits extras; as entradas
+// com filtro de bloco publicam a saída dele
+static void process_block(const uint16_t *samples) {
+  uint32_t sum[ADC_ACQ_MAX_INPUTS] = {0};
+
+  for (uint i = 0; i < block_len; i += input_count) {
+    for (uint8_t slot = 0; slot < input_count; ++slot)
+      sum[slot] += samples[i + slot] & 0x0FFF;
+  }
+
+  // 4^n amostras somadas e deslocadas n bits: n bits efetivos a mais
+  for (uint8_t slot = 0; slot < input_count; ++slot) {
+    uint8_t input = inputs[slot];
+    if (!filters[input].fn) {
+      raw_value[input] = sum[slot] >> oversample_bits;
+      continue;
+    }
+
+    uint count = 0;
+    for (uint i = slot; i < block_len; i += input_count)
+      filter_samples[count++] = samples[i] & 0x0FFF;
+    raw_value[input] = filters[input].fn(filter_samples, count, filters[input].data);
+  }
+
+  block_time_us = time_us_32();
+  sequence++;
+  if (block_callback)
+    block_callback();
+}
+
+static void adc_acq_dma_irq_handler(void) {
+  for (uint half = 0; half < 2; ++half) {
+    if (dma_chan[half] < 0 || !dma_channel_get_irq1_status(dma_chan[half]))
+      continue;
+
+    dma_channel_acknowledge_irq1(dma_chan[half]);
+    if (single_block) {
+      // O encadeamento já disparou o outro canal: ele é abortado junto com o ADC
+      single_block = false;
+      adc_run(false);
+      dma_channel_abort(dma_chan[half ^ 1]);
+      dma_channel_acknowledge_irq1(dma_chan[half ^ 1]);
+      adc_fifo_drain();
+      process_block(buffer[half]);
+      return;
+    }
+    // O outro canal já está rodando; este é rearmado para a próxima volta
+    dma_channel_set_write_addr(dma_chan[half], buffer[half], false);
+    process_block(buffer[half]);
+  }
+}
+
+void adc_acq_init(const adc_acq_config_t *config) {
+  oversample_bits = config->oversample_bits;
+  if (oversample_bits > ADC_ACQ_MAX_OVERSAMPLE_BITS)
+    oversample_bits = ADC_ACQ_MAX_OVERSAMPLE_BITS;
+
+  adc_init();
+
+  input_count = 0;
+  for (uint input = 0; input < ADC_ACQ_MAX_INPUTS; ++input) {
+    if (!(config->input_mask & (1u << input)))
+      continue;
+    inputs[input_count++] = input;
+    if (input < 4)
+      adc_gpio_init(26 + input);
+    else
+      adc_set_temp_sensor_enabled(true);
+  }
+
+  // Cada metade do buffer rende exatamente um valor decimado por entrada
+  block_len = input_count << (2 * oversample_bits);
+
+  // O round-robin começa na menor entrada, então a posição no bloco identifica a entrada
+  adc_set_round_robin(config->input_mask & 0x1F);
+  adc_fifo_setup(true, true, 1, false, false);
+
+  // Período entre conversões = (1 + div) ciclos; abaixo de 96 ciclos o ADC converte sem pausa
+  if (config->sample_rate_hz >= ADC_CLOCK_HZ / ADC_CYCLES_PER_SAMPLE)
+    adc_set_clkdiv(0);
+  else
+    adc_set_clkdiv((float)ADC_CLOCK_HZ / config->sample_rate_hz - 1.0f);
+
+  for (uint half = 0; half < 2; ++half)
+    dma_chan[half] = dma_claim_unused_channel(true);
+
+  for (uint half = 0; half < 2; ++half) {
+    dma_channel_config dma_config = dma_channel_get_default_config(dma_chan[half]);
+    channel_config_set_transfer_data_size(&dma_config, DMA_SIZE_16);
+    channel_config_set_read_increment(&dma_config, false);
+    channel_config_set_write_increment(&dma_config, true);
+    channel_config_set_dreq(&dma_config, DREQ_ADC);
+    channel_config_set_chain_to(&dma_config, dma_chan[half ^ 1]);
+    dma_channel_configure(dma_chan[half], &dma_config, buffer[half], &adc_hw->fifo, block_len, false);
+    dma_channel_set_irq1_enabled(dma_chan[half], true);
+  }
+
+  irq_add_shared_handler(DMA_IRQ_1, adc_acq_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+  irq_set_enabled(DMA_IRQ_1, true);
+}
+
+void adc_acq_start(void) {
+  for (uint half = 0; half < 2; ++half) {
+    dma_channel_set_write_addr(dma_chan[half], buffer[half], false);
+    dma_channel_set_trans_count(dma_chan[half], block_len, false);
+  }
+
+  // O round-robin começa na menor entrada, então a posição no bloco identifica a entrada
+  adc_select_input(inputs[0]);
+  adc_fifo_drain();
+  dma_channel_start(dma_chan[0]);
+  adc_run(true);
+}
+
+void adc_acq_stop(void) {
+  adc_run(false);
+  dma_channel_abort(dma_chan[0]);
+  dma_channel_abort(dma_chan[1]);
+  adc_fifo_drain();
+}
+
+// Converte um único bloco e deixa o ADC parado; dorme em __wfi até a interrupção do DMA
+// publicar o resultado. A aquisição contínua deve estar parada (adc_acq_stop)
+void adc_acq_capture(void) {
+  uint32_t start = sequence;
+  single_block = true;
+  adc_acq_start();
+
+  // Com as interrupções desligadas, a do DMA ainda acorda o __wfi e roda ao reabilitar
+  uint32_t status = save_and_disable_interrupts();
+  while (sequence == start) {
+    __wfi();
+    restore_interrupts(status);
+    status = save_and_disable_interrupts();
+  }
+  restore_interrupts(status);
+}
+
+// Último valor da entrada na escala de 12 bits (0 a 4095)
+uint16_t adc_acq_read(uint input) {
+  return raw_value[input] >> oversample_bits;
+}
+
+// Último valor da entrada com a resolução completa (12 + bits de sobreamostragem)
+uint32_t adc_acq_read_raw(uint input) {
+  return raw_value[input];
+}
+
+uint8_t adc_acq_bits(void) {
+  return 12 + oversample_bits;
+}
+
+// Contador de blocos processados, útil para saber se há valores novos
+uint32_t adc_acq_sequence(void) {
+  return sequence;
+}
+
+// Instante em que o último bloco foi publicado: a idade dos valores lidos agora
+uint32_t adc_acq_timestamp(void) {
+  return block_time_us;
+}
+
+void adc_acq_set_block_callback(adc_acq_block_callback_t callback) {
+  block_callback = callback;
+}
+
+// Troca a média do bloco da entrada por um filtro (NULL volta à média). Deve ser chamada com a
+// aquisição parada, pois o filtro roda na interrupção do DMA
+void adc_acq_set_filter(uint input, adc_acq_filter_t filter, void *data) {
+  if (input >= ADC_ACQ_MAX_INPUTS)
+    return;
+  filters[input].fn = filter;
+  filters[input].data = data;
+}
@@ -0,0 +1,48 @@
+/*
+O arquivo adc_acq.h declara o subsistema de aquisição contínua do ADC.
+O ADC roda em modo livre, alternando entre as entradas selecionadas (round-robin), e o DMA
+copia as conversões para um buffer duplo. Cada bloco é decimado (sobreamostragem, ou o filtro
+de bloco da entrada) e o valor mais recente de cada entrada fica disponível sem bloquear,
+independente do restante do laço.
+No modo de baixo consumo o ADC fica parado e adc_acq_capture converte um único bloco por amostra.
+*/
+
+#ifndef ADC_ACQ_H
+#define ADC_ACQ_H
+
+#include "pico/stdlib.h"
+
+// Entradas do ADC: 0 a 3 (GPIO 26 a 29) e 4 (sensor de temperatura interno)
+#define ADC_ACQ_MAX_INPUTS 5
+
+// Limite de bits extras por sobreamostragem (4^4 = 256 amostras por valor)
+#define ADC_ACQ_MAX_OVERSAMPLE_BITS 4
+
+typedef struct {
+  uint8_t input_mask;       // bit n habilita a entrada ADCn
+  uint32_t sample_rate_hz;  // conversões por segundo somando todas as entradas
+  uint8_t oversample_bits;  // cada valor é a média de 4^n amostras, com n bits extras
+} adc_acq_config_t;
+
+// Chamada na interrupção do DMA sempre que um bloco novo é publicado
+typedef void (*adc_acq_block_callback_t)(void);
+
+// Filtro de bloco de uma entrada, chamado na interrupção do DMA no lugar da média: recebe as
+// amostras da entrada no bloco (12 bits, na ordem de conversão; o buffer pode ser alterado) e
+// retorna o valor a publicar, na resolução completa (adc_acq_bits)
+typedef uint32_t (*adc_acq_filter_t)(int16_t *samples, uint count, void *data);
+
+void adc_acq_init(const adc_acq_config_t *config);
+void adc_acq_start(void);
+void adc_acq_stop(void);
+void adc_acq_capture(void);
+
+uint16_t adc_acq_read(uint input);
+uint32_t adc_acq_read_raw(uint input);
+uint8_t adc_acq_bits(void);
+uint32_t adc_acq_sequence(void);
+uint32_t adc_acq_timestamp(void);
+void adc_acq_set_block_callback(adc_acq_block_callback_t callback);
+void adc_acq_set_filter(uint input, adc_acq_filter_t filter, void *data);
+
+#endif
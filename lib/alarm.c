@@ -0,0 +1,177 @@
+/*
+O arquivo alarm.c implementa o motor de alarme dos canais de medição.
+alarm_update roda junto da aquisição, uma vez por bloco novo do ADC: guarda a amostra na janela
+da inclinação, compara o valor com os limites (com histerese em relação à faixa atual), só
+confirma a mudança depois do tempo mínimo e, na faixa normal, projeta o valor pelo horizonte da
+previsão. A fila de eventos tem um produtor (a aquisição) e um consumidor (o acionamento).
+*/
+
+#include "alarm.h"
+#include "hardware/sync.h"
+
+static alarm_event_t events[ALARM_EVENT_QUEUE_SIZE];
+static volatile uint32_t event_head, event_tail;
+static alarm_notify_t notify;
+static alarm_stats_t stats;
+
+void alarm_init(alarm_notify_t callback) {
+  notify = callback;
+  event_head = event_tail = 0;
+  alarm_reset_stats();
+}
+
+// Faixa confirmada de um estado: as previsões pertencem à faixa normal
+static inline alarm_state_t alarm_range(alarm_state_t state) {
+  return state == ALARM_LOW || state == ALARM_HIGH ? state : ALARM_NORMAL;
+}
+
+// Inclinação por mínimos quadrados na janela, em unidades por segundo. Os tempos entram em
+// milissegundos para os produtos caberem em 64 bits mesmo com um minuto entre as amostras
+static int32_t alarm_slope(const alarm_channel_t *a) {
+  if (a->count < 2)
+    return 0;
+
+  uint8_t oldest = (a->next + ALARM_SLOPE_SAMPLES - a->count) % ALARM_SLOPE_SAMPLES;
+  int64_t t[ALARM_SLOPE_SAMPLES], v[ALARM_SLOPE_SAMPLES];
+  int64_t sum_t = 0, sum_v = 0;
+  for (uint8_t i = 0; i < a->count; ++i) {
+    uint8_t index = (oldest + i) % ALARM_SLOPE_SAMPLES;
+    t[i] = (a->times_us[index] - a->times_us[oldest]) / 1000;
+    v[i] = a->values[index] - a->values[oldest];
+    sum_t += t[i];
+    sum_v += v[i];
+  }
+
+  // Desvios multiplicados por count, para ficar em inteiros: a razão não muda
+  int64_t num = 0, den = 0;
+  for (uint8_t i = 0; i < a->count; ++i) {
+    int64_t dt = t[i] * a->count - sum_t;
+    num += dt * (v[i] * a->count - sum_v);
+    den += dt * dt;
+  }
+  return den ? (int32_t)(num * 1000 / den) : 0;
+}
+
+// Faixa indicada pelo valor: a faixa atual só é deixada com o valor além da histerese
+static alarm_state_t alarm_target(const alarm_config_t *c, alarm_state_t range, int32_t value) {
+  if (range == ALARM_HIGH && value > c->high.threshold - c->high.hysteresis)
+    return ALARM_HIGH;
+  if (range == ALARM_LOW && value < c->low.threshold + c->low.hysteresis)
+    return ALARM_LOW;
+  if (value > c->high.threshold)
+    return ALARM_HIGH;
+  if (value < c->low.threshold)
+    return ALARM_LOW;
+  return ALARM_NORMAL;
+}
+
+// Tempo mínimo da mudança: o do nível em que se entra ou, na volta ao normal, o do que se
+// deixa. A previsão de um nível usa o tempo dele
+static uint32_t alarm_dwell_us(const alarm_config_t *c, alarm_state_t state, alarm_state_t target) {
+  alarm_state_t level = target == ALARM_NORMAL ? state : target;
+  return 1000 * (level == ALARM_HIGH || level == ALARM_PREDICT_HIGH ? c->high.dwell_ms : c->low.dwell_ms);
+}
+
+// Na faixa normal: o valor projetado pelo horizonte da previsão cruza algum limite?
+static alarm_state_t alarm_predict(const alarm_channel_t *a, int32_t value) {
+  const alarm_config_t *c = a->config;
+  if (!c->predict_ms || a->count < ALARM_SLOPE_SAMPLES / 2)
+    return ALARM_NORMAL;
+
+  int64_t projected = value + (int64_t)a->slope * c->predict_ms / 1000;
+  // Uma previsão em curso só termina com a projeção recuando a histerese
+  int64_t high = c->high.threshold - (a->state == ALARM_PREDICT_HIGH ? c->high.hysteresis : 0);
+  int64_t low = c->low.threshold + (a->state == ALARM_PREDICT_LOW ? c->low.hysteresis : 0);
+  if (projected > high)
+    return ALARM_PREDICT_HIGH;
+  if (projected < low)
+    return ALARM_PREDICT_LOW;
+  return ALARM_NORMAL;
+}
+
+// Coloca um evento na fila (aquisição, produtor)
+static void alarm_emit(const alarm_event_t *event) {
+  uint32_t head = event_head;
+  if (head - event_tail >= ALARM_EVENT_QUEUE_SIZE) {
+    stats.dropped++;
+    return;
+  }
+
+  events[head % ALARM_EVENT_QUEUE_SIZE] = *event;
+  __dmb();
+  event_head = head + 1;
+  stats.events++;
+  if (event->to == ALARM_PREDICT_LOW || event->to == ALARM_PREDICT_HIGH)
+    stats.predictions++;
+
+  if (notify)
+    notify();
+}
+
+// Avalia uma amostra nova do canal (índice usado nos eventos). Retorna true se o estado mudou
+bool alarm_update(alarm_channel_t *a, uint8_t channel, int32_t value, uint32_t sample_us) {
+  const alarm_config_t *c = a->config;
+  stats.samples++;
+
+  a->values[a->next] = value;
+  a->times_us[a->next] = sample_us;
+  a->next = (a->next + 1) % ALARM_SLOPE_SAMPLES;
+  if (a->count < ALARM_SLOPE_SAMPLES)
+    a->count++;
+  a->slope = alarm_slope(a);
+
+  alarm_state_t target = alarm_target(c, alarm_range(a->state), value);
+  if (target == ALARM_NORMAL)
+    target = alarm_predict(a, value);
+
+  // O estado só muda com a condição mantida pelo tempo mínimo, previsões incluídas (uma
+  // inclinação ruidosa não pisca o aviso); uma condição que se desfaz antes disso é contada
+  // como oscilação evitada
+  if (target == a->state) {
+    if (a->pending != a->state) {
+      stats.suppressed++;
+      a->pending = a->state;
+    }
+    return false;
+  }
+  if (a->pending != target) {
+    a->pending = target;
+    a->pending_us = sample_us;
+  }
+  if (sample_us - a->pending_us < alarm_dwell_us(c, a->state, target))
+    return false;
+
+  alarm_emit(&(alarm_event_t){channel, a->state, target, value, a->slope, sample_us, time_us_32()});
+  a->state = target;
+  return true;
+}
+
+// Retira o evento mais antigo (acionamento, consumidor)
+bool alarm_pop(alarm_event_t *event) {
+  uint32_t tail = event_tail;
+  if (tail == event_head)
+    return false;
+
+  __dmb();
+  *event = events[tail % ALARM_EVENT_QUEUE_SIZE];
+  __dmb();
+  event_tail = tail + 1;
+  return true;
+}
+
+// Chamada depois de acionar as saídas para o evento: registra a latência desde a amostra
+void alarm_actuated(const alarm_event_t *event) {
+  uint32_t latency = time_us_32() - event->sample_us;
+  stats.actuated++;
+  stats.latency_sum_us += latency;
+  if (latency > stats.latency_max_us)
+    stats.latency_max_us = latency;
+}
+
+void alarm_get_stats(alarm_stats_t *out) {
+  *out = stats;
+}
+
+void alarm_reset_stats(void) {
+  stats = (alarm_stats_t){0};
+}
@@ -0,0 +1,84 @@
+/*
+O arquivo alarm.h declara o motor de alarme dos canais de medição.
+Cada canal tem limites próprios para as faixas baixa e alta, com histerese e tempo mínimo de
+permanência, então um valor parado em cima de um limite não faz LEDs, matriz e buzzer oscilarem.
+A inclinação estimada nas últimas amostras dispara um alarme preditivo antes de o limite ser
+cruzado. Cada mudança de estado vira um evento numa fila sem travas; quem aciona as saídas
+retira os eventos e informa o acionamento, o que mede a latência da amostra até a saída.
+*/
+
+#ifndef ALARM_H
+#define ALARM_H
+
+#include "pico/stdlib.h"
+
+// Amostras usadas na estimativa da inclinação
+#define ALARM_SLOPE_SAMPLES 8
+
+// Posições da fila de eventos (potência de 2)
+#define ALARM_EVENT_QUEUE_SIZE 16
+
+typedef struct {
+  int32_t threshold;   // limite: a faixa baixa fica abaixo dele e a alta, acima
+  int32_t hysteresis;  // para sair da faixa o valor precisa recuar essa margem além do limite
+  uint32_t dwell_ms;   // tempo mínimo da condição nova antes de entrar na faixa ou sair dela
+} alarm_level_t;
+
+typedef struct {
+  alarm_level_t low, high;
+  uint32_t predict_ms;  // horizonte do alarme preditivo (0 desliga)
+} alarm_config_t;
+
+// Estado do alarme de um canal; o normal vale zero para os canais começarem nele
+typedef enum {
+  ALARM_NORMAL,
+  ALARM_LOW,
+  ALARM_HIGH,
+  ALARM_PREDICT_LOW,   // ainda normal, mas a tendência cruza o limite baixo dentro do horizonte
+  ALARM_PREDICT_HIGH,  // ainda normal, mas a tendência cruza o limite alto dentro do horizonte
+} alarm_state_t;
+
+// Estado do motor para um canal; só a configuração é preenchida por quem declara o canal
+typedef struct {
+  const alarm_config_t *config;
+  alarm_state_t state;
+  alarm_state_t pending;     // estado para o qual o valor aponta, esperando o tempo mínimo
+  uint32_t pending_us;       // início da condição pendente
+  int32_t slope;             // inclinação estimada, em unidades por segundo
+  int32_t values[ALARM_SLOPE_SAMPLES];
+  uint32_t times_us[ALARM_SLOPE_SAMPLES];
+  uint8_t count, next;
+} alarm_channel_t;
+
+typedef struct {
+  uint8_t channel;
+  alarm_state_t from, to;
+  int32_t value;       // valor que causou a mudança
+  int32_t slope;       // unidades por segundo
+  uint32_t sample_us;  // instante da amostra (publicação do bloco do ADC)
+  uint32_t queued_us;  // evento colocado na fila
+} alarm_event_t;
+
+// Chamada sempre que um evento entra na fila, por exemplo para disparar a tarefa que os consome
+typedef void (*alarm_notify_t)(void);
+
+typedef struct {
+  uint32_t samples;
+  uint32_t events;
+  uint32_t predictions;   // eventos de alarme preditivo
+  uint32_t suppressed;    // cruzamentos desfeitos antes do tempo mínimo (oscilações evitadas)
+  uint32_t dropped;       // fila de eventos cheia
+  // Latência da amostra até alarm_actuated
+  uint32_t actuated;
+  uint32_t latency_max_us;
+  uint64_t latency_sum_us;
+} alarm_stats_t;
+
+void alarm_init(alarm_notify_t notify);
+bool alarm_update(alarm_channel_t *alarm, uint8_t channel, int32_t value, uint32_t sample_us);
+bool alarm_pop(alarm_event_t *event);
+void alarm_actuated(const alarm_event_t *event);
+void alarm_get_stats(alarm_stats_t *stats);
+void alarm_reset_stats(void);
+
+#endif
@@ -0,0 +1,120 @@
+/*
+O arquivo buzzer.c implementa o motor de tons do buzzer com PWM.
+A frequência é obtida ajustando o divisor e o valor de wrap da fatia; o ciclo de trabalho
+define o volume percebido. Um alarme do SDK troca de nota ao fim de cada duração.
+*/
+
+#include "buzzer.h"
+#include "hardware/clocks.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+
+static uint slice;
+static uint channel;
+
+// Fila circular: o laço principal produz e o alarme consome
+static buzzer_note_t queue[BUZZER_QUEUE_SIZE];
+static volatile uint8_t head, tail;
+static volatile bool playing;
+static alarm_id_t alarm;
+
+// Configura a fatia para a frequência e o ciclo de trabalho da nota (frequência 0 = silêncio)
+static void apply_note(const buzzer_note_t *note) {
+  if (!note->frequency_hz || !note->duty_percent) {
+    pwm_set_chan_level(slice, channel, 0);
+    return;
+  }
+
+  // A fatia só gera frequências entre clk_sys / (255 * 65536), com o maior divisor inteiro e o
+  // maior wrap, e clk_sys / 2; fora disso a nota fica no limite mais próximo
+  uint32_t clock_hz = clock_get_hz(clk_sys);
+  uint32_t frequency_hz = note->frequency_hz;
+  uint32_t min_hz = clock_hz / (255u * 65536u) + 1;
+  if (frequency_hz < min_hz)
+    frequency_hz = min_hz;
+  else if (frequency_hz > clock_hz / 2)
+    frequency_hz = clock_hz / 2;
+
+  // Menor divisor inteiro (8 bits) que mantém o wrap dentro de 16 bits
+  uint32_t divider = clock_hz / frequency_hz / 65536u + 1;
+  if (divider > 255)
+    divider = 255;
+  uint32_t wrap = clock_hz / (divider * frequency_hz) - 1;
+
+  pwm_set_clkdiv_int_frac(slice, divider, 0);
+  pwm_set_wrap(slice, wrap);
+  pwm_set_chan_level(slice, channel, (wrap + 1) * note->duty_percent / 100);
+}
+
+// Executa a próxima nota da fila e retorna em quanto tempo o alarme deve voltar
+static int64_t next_note(alarm_id_t id, void *user_data) {
+  (void)id;
+  (void)user_data;
+
+  if (head == tail) {
+    pwm_set_chan_level(slice, channel, 0);
+    playing = false;
+    return 0;
+  }
+
+  const buzzer_note_t *note = &queue[tail];
+  apply_note(note);
+  int64_t duration_us = (int64_t)note->duration_ms * 1000;
+  tail = (tail + 1) % BUZZER_QUEUE_SIZE;
+
+  // Negativo: reagenda em relação ao disparo anterior, sem acumular atraso
+  return -duration_us;
+}
+
+void buzzer_init(uint gpio) {
+  slice = pwm_gpio_to_slice_num(gpio);
+  channel = pwm_gpio_to_channel(gpio);
+
+  gpio_set_function(gpio, GPIO_FUNC_PWM);
+  pwm_set_chan_level(slice, channel, 0);
+  pwm_set_enabled(slice, true);
+
+  head = tail = 0;
+  playing = false;
+}
+
+// Enfileira uma sequência de notas; retorna false se não houver espaço para todas
+bool buzzer_play(const buzzer_note_t *notes, uint count) {
+  uint8_t used = (head + BUZZER_QUEUE_SIZE - tail) % BUZZER_QUEUE_SIZE;
+  if (count > (uint)(BUZZER_QUEUE_SIZE - 1 - used))
+    return false;
+
+  for (uint i = 0; i < count; ++i) {
+    queue[head] = notes[i];
+    head = (head + 1) % BUZZER_QUEUE_SIZE;
+  }
+
+  // Inicia o alarme se o motor estava parado; caso contrário as notas entram na sequência
+  uint32_t status = save_and_disable_interrupts();
+  bool start = !playing;
+  playing = true;
+  restore_interrupts(status);
+
+  if (start)
+    alarm = add_alarm_in_us(0, next_note, NULL, true);
+
+  return true;
+}
+
+bool buzzer_tone(uint16_t frequency_hz, uint16_t duration_ms) {
+  buzzer_note_t note = {frequency_hz, duration_ms, 50};
+  return buzzer_play(&note, 1);
+}
+
+// Interrompe o som e descarta as notas pendentes
+void buzzer_stop(void) {
+  if (playing)
+    cancel_alarm(alarm);
+  tail = head;
+  playing = false;
+  pwm_set_chan_level(slice, channel, 0);
+}
+
+bool buzzer_busy(void) {
+  return playing;
+}
@@ -0,0 +1,27 @@
+/*
+O arquivo buzzer.h declara o motor de tons do buzzer.
+O buzzer é acionado por uma fatia de PWM e as notas (frequência, duração e ciclo de trabalho)
+ficam em uma fila que avança por um alarme de hardware, sem bloquear o laço principal.
+*/
+
+#ifndef BUZZER_H
+#define BUZZER_H
+
+#include "pico/stdlib.h"
+
+// Capacidade da fila de notas
+#define BUZZER_QUEUE_SIZE 16
+
+typedef struct {
+  uint16_t frequency_hz;  // 0 = silêncio
+  uint16_t duration_ms;
+  uint8_t duty_percent;   // 50 = onda quadrada
+} buzzer_note_t;
+
+void buzzer_init(uint gpio);
+bool buzzer_play(const buzzer_note_t *notes, uint count);
+bool buzzer_tone(uint16_t frequency_hz, uint16_t duration_ms);
+void buzzer_stop(void);
+bool buzzer_busy(void);
+
+#endif
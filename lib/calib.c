@@ -0,0 +1,30 @@
+/*
+O arquivo calib.c implementa a conversão por tabela de calibração.
+A leitura de n bits é levada a 16 bits; os bits altos escolhem o segmento da tabela e os
+baixos são a fração (Q11) usada na interpolação. Não há divisões nem ponto flutuante.
+*/
+
+#include "calib.h"
+
+// Leva uma leitura de bits bits (12 a 16) para a escala de CALIB_INPUT_BITS
+static inline uint32_t calib_normalize(uint32_t raw, uint8_t bits) {
+  return bits < CALIB_INPUT_BITS ? raw << (CALIB_INPUT_BITS - bits) : raw >> (bits - CALIB_INPUT_BITS);
+}
+
+// Converte a leitura do ADC com a curva da tabela (interpolação linear entre os pontos)
+int32_t calib_convert(const calib_table_t *table, uint32_t raw, uint8_t bits) {
+  uint32_t x = calib_normalize(raw, bits);
+  uint32_t segment = x >> CALIB_FRAC_BITS;
+  int32_t frac = x & ((1u << CALIB_FRAC_BITS) - 1);
+
+  int32_t y0 = table->points[segment];
+  int32_t y1 = table->points[segment + 1];
+  // Produto em 32 bits (o M0+ não multiplica 64 bits em hardware): vale para
+  // diferenças entre pontos vizinhos menores que 2^20 unidades
+  return y0 + (((y1 - y0) * frac) >> CALIB_FRAC_BITS);
+}
+
+// Tensão em milivolts (referência de 3,3 V): 3300/4095 em Q16 evita a divisão
+uint32_t calib_millivolts(uint32_t raw, uint8_t bits) {
+  return (calib_normalize(raw, bits) * 52813u) >> 20;
+}
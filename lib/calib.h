@@ -0,0 +1,71 @@
+/*
+O arquivo calib.h declara a conversão em ponto fixo de leituras do ADC para grandezas físicas.
+A curva do sensor é uma tabela de CALIB_POINTS pontos igualmente espaçados na faixa do ADC,
+gerada em tempo de compilação pelas macros abaixo, e a leitura é interpolada linearmente
+entre os dois pontos vizinhos usando só inteiros.
+
+Exemplos:
+  static const calib_table_t linear = CALIB_TABLE(CALIB_LINEAR, 0, 50000);
+  static const calib_table_t ntc = CALIB_TABLE(CALIB_NTC_BETA, 3950, 10000, 10000);
+*/
+
+#ifndef CALIB_H
+#define CALIB_H
+
+#include "pico/stdlib.h"
+
+// 32 segmentos de 128 contagens (ADC de 12 bits) e o ponto final em 4096
+#define CALIB_SEGMENT_BITS 5
+#define CALIB_POINTS ((1 << CALIB_SEGMENT_BITS) + 1)
+
+// A leitura é normalizada para 16 bits: 5 bits de segmento e 11 de fração (Q11)
+#define CALIB_INPUT_BITS 16
+#define CALIB_FRAC_BITS (CALIB_INPUT_BITS - CALIB_SEGMENT_BITS)
+
+typedef struct {
+  int32_t points[CALIB_POINTS];
+} calib_table_t;
+
+// Contagem (12 bits) do ponto i, com os extremos afastados de 0 e 4095 para as curvas que dividem por eles
+#define CALIB_RAW(i) ((i) * 4096.0 / (1 << CALIB_SEGMENT_BITS))
+#define CALIB_RAW_CLAMPED(i) (CALIB_RAW(i) < 1.0 ? 1.0 : CALIB_RAW(i) > 4094.0 ? 4094.0 : CALIB_RAW(i))
+#define CALIB_ROUND(x) ((int32_t)((x) < 0 ? (x) - 0.5 : (x) + 0.5))
+
+// Reta: a contagem 0 vale v0 e a contagem 4095 vale v1 (mesma unidade da saída)
+#define CALIB_LINEAR(i, v0, v1) CALIB_ROUND((v0) + ((double)(v1) - (v0)) * CALIB_RAW(i) / 4095.0)
+
+// Termistor NTC ligado ao terra com resistor fixo para 3,3 V; saída em miligraus Celsius
+#define CALIB_NTC_RESISTANCE(i, r_fixed) ((r_fixed) * CALIB_RAW_CLAMPED(i) / (4095.0 - CALIB_RAW_CLAMPED(i)))
+
+// Modelo Beta: beta em K, r25 é a resistência a 25 °C
+#define CALIB_NTC_BETA(i, beta, r25, r_fixed) \
+  CALIB_ROUND(1000.0 * (1.0 / (1.0 / 298.15 + __builtin_log(CALIB_NTC_RESISTANCE(i, r_fixed) / (r25)) / (beta)) - 273.15))
+
+// Modelo de Steinhart-Hart: 1/T = a + b ln R + c (ln R)^3
+#define CALIB_NTC_SH_LN(i, r_fixed) __builtin_log(CALIB_NTC_RESISTANCE(i, r_fixed))
+#define CALIB_NTC_SH(i, a, b, c, r_fixed) \
+  CALIB_ROUND(1000.0 * (1.0 / ((a) + (b) * CALIB_NTC_SH_LN(i, r_fixed) + \
+    (c) * CALIB_NTC_SH_LN(i, r_fixed) * CALIB_NTC_SH_LN(i, r_fixed) * CALIB_NTC_SH_LN(i, r_fixed)) - 273.15))
+
+// Sensor de temperatura interno do RP2040 (ADC4): T = 27 - (V - 0,706) / 0,001721, com a
+// referência do ADC em mV; saída em miligraus Celsius
+#define CALIB_RP2040_TEMP(i, vref_mv) \
+  CALIB_ROUND(1000.0 * (27.0 - (CALIB_RAW(i) * (vref_mv) / 4095000.0 - 0.706) / 0.001721))
+
+// Tabela com os CALIB_POINTS pontos de uma curva; o GCC avalia as expressões (inclusive
+// __builtin_log) na compilação, então nenhuma conta de ponto flutuante chega ao firmware
+#define CALIB_TABLE(curve, ...) {{ \
+  curve(0, __VA_ARGS__), curve(1, __VA_ARGS__), curve(2, __VA_ARGS__), curve(3, __VA_ARGS__), \
+  curve(4, __VA_ARGS__), curve(5, __VA_ARGS__), curve(6, __VA_ARGS__), curve(7, __VA_ARGS__), \
+  curve(8, __VA_ARGS__), curve(9, __VA_ARGS__), curve(10, __VA_ARGS__), curve(11, __VA_ARGS__), \
+  curve(12, __VA_ARGS__), curve(13, __VA_ARGS__), curve(14, __VA_ARGS__), curve(15, __VA_ARGS__), \
+  curve(16, __VA_ARGS__), curve(17, __VA_ARGS__), curve(18, __VA_ARGS__), curve(19, __VA_ARGS__), \
+  curve(20, __VA_ARGS__), curve(21, __VA_ARGS__), curve(22, __VA_ARGS__), curve(23, __VA_ARGS__), \
+  curve(24, __VA_ARGS__), curve(25, __VA_ARGS__), curve(26, __VA_ARGS__), curve(27, __VA_ARGS__), \
+  curve(28, __VA_ARGS__), curve(29, __VA_ARGS__), curve(30, __VA_ARGS__), curve(31, __VA_ARGS__), \
+  curve(32, __VA_ARGS__) }}
+
+int32_t calib_convert(const calib_table_t *table, uint32_t raw, uint8_t bits);
+uint32_t calib_millivolts(uint32_t raw, uint8_t bits);
+
+#endif
@@ -0,0 +1,199 @@
+/*
+O arquivo dsp.c implementa os filtros em ponto fixo por bloco.
+Todos aceitam a saída no mesmo buffer da entrada, menos o FIR com decimação, que escreve menos
+saídas que entradas e em 32 bits. Na primeira amostra o estado é preenchido com ela, então o
+filtro parte do valor medido e não de zero.
+*/
+
+#include <string.h>
+#include "dsp.h"
+
+// ---------------------------------------------------------------- Média móvel
+
+void dsp_moving_average_init(dsp_moving_average_t *filter, uint8_t shift) {
+  memset(filter, 0, sizeof(*filter));
+  filter->shift = shift > DSP_MOVING_AVERAGE_MAX_SHIFT ? DSP_MOVING_AVERAGE_MAX_SHIFT : shift;
+  filter->pos = 0xFF;  // nenhuma amostra ainda
+}
+
+void dsp_moving_average(dsp_moving_average_t *filter, const int16_t *in, int16_t *out, uint count) {
+  uint8_t length = 1u << filter->shift;
+  uint8_t pos = filter->pos;
+  int32_t sum = filter->sum;
+
+  if (count && pos == 0xFF) {
+    for (uint8_t i = 0; i < length; ++i)
+      filter->window[i] = in[0];
+    sum = in[0] * (1 << filter->shift);
+    pos = 0;
+  }
+
+  for (uint i = 0; i < count; ++i) {
+    int16_t x = in[i];
+    sum += x - filter->window[pos];
+    filter->window[pos] = x;
+    pos = (pos + 1) & (length - 1);
+    out[i] = (int16_t)(sum >> filter->shift);
+  }
+
+  filter->pos = pos;
+  filter->sum = sum;
+}
+
+// ---------------------------------------------------------------- Mediana
+
+void dsp_median_init(dsp_median_t *filter, uint8_t length) {
+  memset(filter, 0, sizeof(*filter));
+  if (length > DSP_MEDIAN_MAX)
+    length = DSP_MEDIAN_MAX;
+  filter->length = length | 1;
+}
+
+static inline int16_t dsp_median3(int16_t a, int16_t b, int16_t c) {
+  int16_t lo = a < b ? a : b;
+  int16_t hi = a < b ? b : a;
+  return c < lo ? lo : c > hi ? hi : c;
+}
+
+// Mediana de uma janela pequena: ordenação por inserção de uma cópia
+static int16_t dsp_median_window(const int16_t *window, uint8_t length) {
+  int16_t sorted[DSP_MEDIAN_MAX];
+  for (uint8_t i = 0; i < length; ++i) {
+    int16_t x = window[i];
+    uint8_t j = i;
+    for (; j > 0 && sorted[j - 1] > x; --j)
+      sorted[j] = sorted[j - 1];
+    sorted[j] = x;
+  }
+  return sorted[length / 2];
+}
+
+void dsp_median(dsp_median_t *filter, const int16_t *in, int16_t *out, uint count) {
+  uint8_t length = filter->length;
+  if (count && !filter->count) {
+    for (uint8_t i = 0; i < length; ++i)
+      filter->window[i] = in[0];
+    filter->count = length;
+  }
+
+  uint8_t pos = filter->pos;
+  for (uint i = 0; i < count; ++i) {
+    filter->window[pos] = in[i];
+    pos = pos + 1 == length ? 0 : pos + 1;
+    // A janela de 3 é a mais usada e dispensa a ordenação
+    out[i] = length == 3 ? dsp_median3(filter->window[0], filter->window[1], filter->window[2]) :
+                           dsp_median_window(filter->window, length);
+  }
+  filter->pos = pos;
+}
+
+// ---------------------------------------------------------------- IIR de primeira ordem
+
+void dsp_iir1_init(dsp_iir1_t *filter, uint8_t shift) {
+  filter->shift = shift;
+  filter->started = false;
+  filter->acc = 0;
+}
+
+void dsp_iir1(dsp_iir1_t *filter, const int16_t *in, int16_t *out, uint count) {
+  uint8_t shift = filter->shift;
+  if (count && !filter->started) {
+    filter->acc = in[0] * (1 << shift);
+    filter->started = true;
+  }
+
+  int32_t acc = filter->acc;
+  for (uint i = 0; i < count; ++i) {
+    acc += in[i] - (acc >> shift);
+    out[i] = (int16_t)(acc >> shift);
+  }
+  filter->acc = acc;
+}
+
+// ---------------------------------------------------------------- Biquad
+
+void dsp_biquad_init(dsp_biquad_t *filter, const dsp_biquad_coeffs_t *coeffs) {
+  memset(filter, 0, sizeof(*filter));
+  filter->coeffs = coeffs;
+  filter->x1 = INT32_MIN;  // nenhuma amostra ainda
+}
+
+void dsp_biquad(dsp_biquad_t *filter, const int16_t *in, int16_t *out, uint count) {
+  const dsp_biquad_coeffs_t *c = filter->coeffs;
+
+  // Parte do regime permanente da primeira amostra (ganho unitário em DC)
+  if (count && filter->x1 == INT32_MIN)
+    filter->x1 = filter->x2 = filter->y1 = filter->y2 = in[0];
+
+  int32_t x1 = filter->x1, x2 = filter->x2, y1 = filter->y1, y2 = filter->y2;
+  int32_t error = filter->error;
+  for (uint i = 0; i < count; ++i) {
+    int32_t x = in[i];
+    int32_t acc = c->b0 * x + c->b1 * x1 + c->b2 * x2 - c->a1 * y1 - c->a2 * y2 + error;
+    int32_t y = acc >> 14;
+    error = acc - y * (1 << 14);
+    if (y > INT16_MAX)
+      y = INT16_MAX;
+    else if (y < INT16_MIN)
+      y = INT16_MIN;
+    x2 = x1;
+    x1 = x;
+    y2 = y1;
+    y1 = y;
+    out[i] = (int16_t)y;
+  }
+
+  filter->x1 = x1;
+  filter->x2 = x2;
+  filter->y1 = y1;
+  filter->y2 = y2;
+  filter->error = error;
+}
+
+// ---------------------------------------------------------------- FIR com decimação
+
+void dsp_fir_init(dsp_fir_t *filter, const int16_t *taps, uint8_t tap_count, uint8_t decimation, uint8_t extra_bits) {
+  memset(filter, 0, sizeof(*filter));
+  filter->taps = taps;
+  filter->tap_count = tap_count > DSP_FIR_MAX_TAPS ? DSP_FIR_MAX_TAPS : tap_count;
+  filter->decimation = decimation ? decimation : 1;
+  filter->extra_bits = extra_bits > 15 ? 15 : extra_bits;
+  filter->pos = 0xFF;  // nenhuma amostra ainda
+}
+
+// Filtra o bloco e retorna quantas saídas foram escritas (count / decimation, mais ou menos
+// uma conforme a fase que sobrou do bloco anterior)
+uint dsp_fir_decimate(dsp_fir_t *filter, const int16_t *in, int32_t *out, uint count) {
+  uint8_t taps = filter->tap_count;
+  uint8_t shift = 15 - filter->extra_bits;
+  int32_t round = shift ? 1 << (shift - 1) : 0;
+  uint8_t pos = filter->pos;
+  uint8_t phase = filter->phase;
+  uint written = 0;
+
+  if (count && pos == 0xFF) {
+    for (uint8_t i = 0; i < 2 * taps; ++i)
+      filter->delay[i] = in[0];
+    pos = 0;
+  }
+
+  for (uint i = 0; i < count; ++i) {
+    // A amostra mais nova fica em delay[pos] e a mais antiga em delay[pos + taps - 1]
+    pos = pos ? pos - 1 : taps - 1;
+    filter->delay[pos] = filter->delay[pos + taps] = in[i];
+    if (++phase < filter->decimation)
+      continue;
+    phase = 0;
+
+    const int16_t *x = &filter->delay[pos];
+    const int16_t *h = filter->taps;
+    int32_t acc = round;
+    for (uint8_t k = 0; k < taps; ++k)
+      acc += h[k] * x[k];
+    out[written++] = acc >> shift;
+  }
+
+  filter->pos = pos;
+  filter->phase = phase;
+  return written;
+}
@@ -0,0 +1,94 @@
+/*
+O arquivo dsp.h declara os filtros em ponto fixo que processam blocos de amostras.
+Cada filtro guarda o próprio estado entre blocos e percorre um bloco inteiro por chamada (o
+bloco que o DMA acabou de preencher), em vez de uma amostra por chamada: o custo de chamada e de
+carregar o estado é pago uma vez por bloco. Os coeficientes são constantes de compilação
+(tabelas const, na flash) em Q14 ou Q15.
+
+As amostras são inteiros de 16 bits com sinal e os acumuladores de 32 bits: o M0+ multiplica
+32x32 -> 32 bits em um ciclo, mas não tem multiplicação com resultado de 64 bits. Com leituras de
+12 bits do ADC, os produtos por coeficientes Q14/Q15 somados cabem com folga em 32 bits.
+*/
+
+#ifndef DSP_H
+#define DSP_H
+
+#include "pico/stdlib.h"
+
+// Conversão de um coeficiente real para Q14, resolvida na compilação
+#define DSP_Q14(x) ((int16_t)((x) * 16384.0 + ((x) >= 0 ? 0.5 : -0.5)))
+
+#define DSP_MOVING_AVERAGE_MAX_SHIFT 5
+#define DSP_MEDIAN_MAX 7
+#define DSP_FIR_MAX_TAPS 32
+
+// Média móvel de 2^shift amostras: soma corrente, uma soma e uma subtração por amostra
+typedef struct {
+  uint8_t shift;
+  uint8_t pos;
+  int32_t sum;
+  int16_t window[1 << DSP_MOVING_AVERAGE_MAX_SHIFT];
+} dsp_moving_average_t;
+
+// Mediana das últimas N amostras (N ímpar até DSP_MEDIAN_MAX): remove picos isolados sem
+// atrasar degraus mais do que (N - 1) / 2 amostras
+typedef struct {
+  uint8_t length;
+  uint8_t pos;
+  uint8_t count;
+  int16_t window[DSP_MEDIAN_MAX];
+} dsp_median_t;
+
+// Passa-baixas de primeira ordem: y += (x - y) / 2^shift, com o estado guardando shift bits
+// fracionários para não perder resolução
+typedef struct {
+  uint8_t shift;
+  bool started;
+  int32_t acc;  // y << shift
+} dsp_iir1_t;
+
+// Coeficientes de uma seção biquadrática em Q14 (|c| < 2), com a0 normalizado para 1:
+// y = b0 x + b1 x[-1] + b2 x[-2] - a1 y[-1] - a2 y[-2]
+typedef struct {
+  int16_t b0, b1, b2, a1, a2;
+} dsp_biquad_coeffs_t;
+
+// Biquad na forma direta I. O resto do deslocamento de cada saída volta na seguinte
+// (realimentação do erro), o que tira o ruído de quantização das frequências baixas e
+// permite polos perto de 1 mesmo com coeficientes de 14 bits
+typedef struct {
+  const dsp_biquad_coeffs_t *coeffs;
+  int32_t x1, x2, y1, y2;
+  int32_t error;
+} dsp_biquad_t;
+
+// FIR com decimação: só uma a cada `decimation` entradas gera saída, e só essas pagam a soma
+// dos produtos. Os coeficientes são Q15 e a saída pode guardar bits extras da filtragem
+// (extra_bits), como a sobreamostragem faz
+typedef struct {
+  const int16_t *taps;
+  uint8_t tap_count;
+  uint8_t decimation;
+  uint8_t extra_bits;
+  uint8_t pos;
+  uint8_t phase;
+  // Linha de atraso duplicada: as últimas tap_count amostras ficam sempre contíguas
+  int16_t delay[2 * DSP_FIR_MAX_TAPS];
+} dsp_fir_t;
+
+void dsp_moving_average_init(dsp_moving_average_t *filter, uint8_t shift);
+void dsp_moving_average(dsp_moving_average_t *filter, const int16_t *in, int16_t *out, uint count);
+
+void dsp_median_init(dsp_median_t *filter, uint8_t length);
+void dsp_median(dsp_median_t *filter, const int16_t *in, int16_t *out, uint count);
+
+void dsp_iir1_init(dsp_iir1_t *filter, uint8_t shift);
+void dsp_iir1(dsp_iir1_t *filter, const int16_t *in, int16_t *out, uint count);
+
+void dsp_biquad_init(dsp_biquad_t *filter, const dsp_biquad_coeffs_t *coeffs);
+void dsp_biquad(dsp_biquad_t *filter, const int16_t *in, int16_t *out, uint count);
+
+void dsp_fir_init(dsp_fir_t *filter, const int16_t *taps, uint8_t tap_count, uint8_t decimation, uint8_t extra_bits);
+uint dsp_fir_decimate(dsp_fir_t *filter, const int16_t *in, int32_t *out, uint count);
+
+#endif
@@ -0,0 +1,239 @@
+/*
+O arquivo flash_log.c implementa o registro persistente na flash.
+Layout de cada setor: página 0 com o cabeçalho e páginas 1 a 15 com 32 registros de 8 bytes.
+Quando o setor atual enche, o próximo (circularmente) é apagado e recebe um cabeçalho com a
+sequência seguinte, descartando os registros mais antigos. Apagar e gravar rodam dentro de
+flash_safe_execute, que suspende as interrupções e o outro núcleo durante a operação.
+*/
+
+#include <stddef.h>
+#include <string.h>
+#include "flash_log.h"
+#include "pico/flash.h"
+
+typedef struct {
+  uint32_t magic;
+  uint32_t sequence;      // cresce a cada setor iniciado
+  uint32_t first_number;  // número do primeiro registro do setor
+  uint32_t magic_check;   // ~magic: cabeçalho gravado por inteiro
+} flash_log_header_t;
+
+// Operação entregue a flash_safe_execute
+typedef struct {
+  uint32_t offset;
+  const uint8_t *data;  // NULL apaga o setor
+} flash_log_op_t;
+
+static flash_log_record_t page_buffer[FLASH_LOG_RECORDS_PER_PAGE];
+static uint8_t page_fill;
+
+static int current_sector = -1;  // -1: log vazio
+static int oldest_sector;
+static uint32_t current_sequence;
+static uint8_t next_page;        // próxima página livre no setor atual (1..15; 16 = cheio)
+static uint32_t next_number;     // número do próximo registro (inclusive os da RAM)
+static uint32_t first_number;    // registro mais antigo ainda na flash
+
+static inline uint32_t sector_offset(int sector) {
+  return FLASH_LOG_OFFSET + sector * FLASH_SECTOR_SIZE;
+}
+
+static inline const uint8_t *flash_ptr(uint32_t offset) {
+  return (const uint8_t *)(XIP_BASE + offset);
+}
+
+static inline const flash_log_header_t *sector_header(int sector) {
+  return (const flash_log_header_t *)flash_ptr(sector_offset(sector));
+}
+
+static inline const flash_log_record_t *page_records(int sector, uint8_t page) {
+  return (const flash_log_record_t *)flash_ptr(sector_offset(sector) + page * FLASH_PAGE_SIZE);
+}
+
+static bool header_valid(const flash_log_header_t *header) {
+  return header->magic == FLASH_LOG_MAGIC && header->magic_check == ~FLASH_LOG_MAGIC;
+}
+
+static uint8_t record_check(const flash_log_record_t *record) {
+  const uint8_t *bytes = (const uint8_t *)record;
+  uint8_t check = 0xA5;
+  for (uint8_t i = 0; i < offsetof(flash_log_record_t, check); ++i)
+    check ^= bytes[i];
+  return check;
+}
+
+// Registro gravado por inteiro: página apagada ou gravação interrompida não conferem
+bool flash_log_record_valid(const flash_log_record_t *record) {
+  return record->number != 0xFFFFFFFFu && record->check == record_check(record);
+}
+
+static void flash_log_do_op(void *param) {
+  const flash_log_op_t *op = param;
+  if (op->data)
+    flash_range_program(op->offset, op->data, FLASH_PAGE_SIZE);
+  else
+    flash_range_erase(op->offset, FLASH_SECTOR_SIZE);
+}
+
+static bool flash_log_run(uint32_t offset, const uint8_t *data) {
+  flash_log_op_t op = {offset, data};
+  return flash_safe_execute(flash_log_do_op, &op, UINT32_MAX) == PICO_OK;
+}
+
+// Primeira página livre do setor; só a primeira palavra de cada página é lida
+static uint8_t find_free_page(int sector) {
+  uint8_t page = 1;
+  while (page < FLASH_LOG_PAGES_PER_SECTOR && page_records(sector, page)->number != 0xFFFFFFFFu)
+    ++page;
+  return page;
+}
+
+// Localiza o setor mais recente pelos cabeçalhos e continua a numeração de onde parou
+void flash_log_init(void) {
+  current_sector = -1;
+  page_fill = 0;
+  next_number = 0;
+  first_number = 0;
+
+  int oldest = -1;
+  for (int sector = 0; sector < FLASH_LOG_SECTORS; ++sector) {
+    const flash_log_header_t *header = sector_header(sector);
+    if (!header_valid(header))
+      continue;
+    if (current_sector < 0 || (int32_t)(header->sequence - current_sequence) > 0) {
+      current_sector = sector;
+      current_sequence = header->sequence;
+    }
+    if (oldest < 0 || (int32_t)(header->sequence - sector_header(oldest)->sequence) < 0)
+      oldest = sector;
+  }
+
+  if (current_sector < 0)
+    return;
+
+  oldest_sector = oldest;
+  first_number = sector_header(oldest)->first_number;
+  next_page = find_free_page(current_sector);
+  next_number = sector_header(current_sector)->first_number;
+
+  // Continua depois do último registro válido da última página gravada
+  if (next_page > 1) {
+    const flash_log_record_t *records = page_records(current_sector, next_page - 1);
+    for (int i = FLASH_LOG_RECORDS_PER_PAGE - 1; i >= 0; --i) {
+      if (flash_log_record_valid(&records[i])) {
+        next_number = records[i].number + 1;
+        break;
+      }
+    }
+  }
+}
+
+// Acrescenta um registro na RAM; retorna true quando uma página completa aguarda gravação
+bool flash_log_append(int16_t value, uint8_t flags) {
+  if (page_fill == FLASH_LOG_RECORDS_PER_PAGE)
+    return true;  // a página anterior ainda não foi gravada: a amostra é descartada
+
+  flash_log_record_t *record = &page_buffer[page_fill++];
+  record->number = next_number++;
+  record->value = value;
+  record->flags = flags;
+  record->check = record_check(record);
+  return page_fill == FLASH_LOG_RECORDS_PER_PAGE;
+}
+
+bool flash_log_commit_pending(void) {
+  return page_fill == FLASH_LOG_RECORDS_PER_PAGE;
+}
+
+// Inicia o próximo setor do rodízio: apaga e grava o cabeçalho
+static bool start_sector(void) {
+  int sector = current_sector < 0 ? 0 : (current_sector + 1) % FLASH_LOG_SECTORS;
+  uint32_t sequence = current_sector < 0 ? 1 : current_sequence + 1;
+
+  // Reaproveitar um setor descarta os registros mais antigos; o seguinte passa a ser o mais antigo
+  bool wraps = current_sector >= 0 && header_valid(sector_header(sector));
+
+  if (!flash_log_run(sector_offset(sector), NULL))
+    return false;
+
+  static uint8_t header_page[FLASH_PAGE_SIZE];
+  memset(header_page, 0xFF, sizeof(header_page));
+  flash_log_header_t header = {FLASH_LOG_MAGIC, sequence, page_buffer[0].number, ~FLASH_LOG_MAGIC};
+  memcpy(header_page, &header, sizeof(header));
+  if (!flash_log_run(sector_offset(sector), header_page))
+    return false;
+
+  if (current_sector < 0) {
+    oldest_sector = sector;
+    first_number = header.first_number;
+  } else if (wraps) {
+    oldest_sector = (sector + 1) % FLASH_LOG_SECTORS;
+    first_number = sector_header(oldest_sector)->first_number;
+  }
+
+  current_sector = sector;
+  current_sequence = sequence;
+  next_page = 1;
+  return true;
+}
+
+// Grava a página completa da RAM; bloqueia as interrupções pelo tempo de gravação
+// (e de apagamento, uma vez a cada FLASH_LOG_RECORDS_PER_SECTOR registros)
+bool flash_log_commit(void) {
+  if (!flash_log_commit_pending())
+    return false;
+
+  if ((current_sector < 0 || next_page >= FLASH_LOG_PAGES_PER_SECTOR) && !start_sector())
+    return false;
+
+  if (!flash_log_run(sector_offset(current_sector) + next_page * FLASH_PAGE_SIZE, (const uint8_t *)page_buffer))
+    return false;
+
+  next_page++;
+  page_fill = 0;
+  return true;
+}
+
+// Número do registro mais antigo na flash
+uint32_t flash_log_first(void) {
+  return first_number;
+}
+
+// Número que o próximo registro vai receber
+uint32_t flash_log_next(void) {
+  return next_number;
+}
+
+// Número de páginas de registros gravadas, do setor mais antigo ao atual
+uint32_t flash_log_pages(void) {
+  if (current_sector < 0)
+    return 0;
+  uint32_t sectors = (current_sector - oldest_sector + FLASH_LOG_SECTORS) % FLASH_LOG_SECTORS;
+  return sectors * (FLASH_LOG_PAGES_PER_SECTOR - 1) + next_page - 1;
+}
+
+// Página gravada pelo índice (0 = mais antiga), lida direto do mapeamento XIP; NULL além do fim
+const uint8_t *flash_log_page(uint32_t index) {
+  if (index >= flash_log_pages())
+    return NULL;
+  int sector = (oldest_sector + index / (FLASH_LOG_PAGES_PER_SECTOR - 1)) % FLASH_LOG_SECTORS;
+  return (const uint8_t *)page_records(sector, 1 + index % (FLASH_LOG_PAGES_PER_SECTOR - 1));
+}
+
+// Entrega os registros gravados com número a partir de first, em ordem
+void flash_log_read(uint32_t first, flash_log_record_fn_t fn, void *data) {
+  uint32_t pages = flash_log_pages();
+  for (uint32_t index = 0; index < pages; ++index) {
+    const flash_log_record_t *records = (const flash_log_record_t *)flash_log_page(index);
+
+    // Páginas inteiras anteriores ao primeiro registro pedido são puladas
+    const flash_log_record_t *last = &records[FLASH_LOG_RECORDS_PER_PAGE - 1];
+    if (flash_log_record_valid(last) && last->number < first)
+      continue;
+
+    for (uint8_t i = 0; i < FLASH_LOG_RECORDS_PER_PAGE; ++i) {
+      if (flash_log_record_valid(&records[i]) && records[i].number >= first)
+        fn(&records[i], data);
+    }
+  }
+}
@@ -0,0 +1,47 @@
+/*
+O arquivo flash_log.h declara o registro persistente de amostras na flash.
+Os registros são acumulados na RAM e gravados uma página (256 bytes) por vez nos últimos
+setores da flash, usados em rodízio para distribuir o desgaste. Cada setor começa com uma
+página de cabeçalho com o número de sequência do setor, de modo que a inicialização encontra
+o ponto de escrita lendo só os cabeçalhos e a primeira palavra de cada página.
+*/
+
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+
+// Setores reservados no fim da flash (4 KB cada)
+#define FLASH_LOG_SECTORS 16
+#define FLASH_LOG_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_LOG_SECTORS * FLASH_SECTOR_SIZE)
+
+#define FLASH_LOG_MAGIC 0x474F4C54u  // "TLOG"
+#define FLASH_LOG_PAGES_PER_SECTOR (FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE)
+
+typedef struct {
+  uint32_t number;  // número do registro, contínuo entre reinícios
+  int16_t value;
+  uint8_t flags;
+  uint8_t check;    // verificação dos bytes anteriores; página apagada ou gravação interrompida não confere
+} flash_log_record_t;
+
+#define FLASH_LOG_RECORDS_PER_PAGE (FLASH_PAGE_SIZE / sizeof(flash_log_record_t))
+#define FLASH_LOG_RECORDS_PER_SECTOR ((FLASH_LOG_PAGES_PER_SECTOR - 1) * FLASH_LOG_RECORDS_PER_PAGE)
+
+// Recebe um registro válido durante a leitura do log
+typedef void (*flash_log_record_fn_t)(const flash_log_record_t *record, void *data);
+
+void flash_log_init(void);
+bool flash_log_record_valid(const flash_log_record_t *record);
+bool flash_log_append(int16_t value, uint8_t flags);
+bool flash_log_commit_pending(void);
+bool flash_log_commit(void);
+
+uint32_t flash_log_first(void);
+uint32_t flash_log_next(void);
+uint32_t flash_log_pages(void);
+const uint8_t *flash_log_page(uint32_t index);
+void flash_log_read(uint32_t first, flash_log_record_fn_t fn, void *data);
+
+#endif
@@ -5,7 +5,7 @@ Aqui contém os bytes que representam cada caractere (números, letras e alguns
 
 
 // Fontes para A-Z e 0-9. Os caracteres tem 8x8 pixels
-static uint8_t font[] = {
+static const uint8_t font[] = {
 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // Nothing
 // Números (0-9)
 0x3e, 0x41, 0x41, 0x49, 0x41, 0x41, 0x3e, 0x00, //0
@@ -72,12 +72,23 @@ static uint8_t font[] = {
 0x44, 0x28, 0x10, 0x28, 0x44, 0x00, 0x00, 0x00, //x
 0x0C, 0x50, 0x50, 0x50, 0x3C, 0x00, 0x00, 0x00, //y
 0x44, 0x64, 0x54, 0x4C, 0x44, 0x00, 0x00, 0x00,  //z
-// Caractere de dois pontos ':' 
-0x00, 0x18, 0x18, 0x00, 0x00, 0x18, 0x18, 0x00,
+// Caractere de dois pontos ':' (já transposto para colunas, como os demais)
+0x00, 0x00, 0x00, 0x66, 0x66, 0x00, 0x00, 0x00,
 // 'Caractere de Barra '/'
 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
 // Caractere '(' (abre parênteses)
 0x00, 0x00, 0x08, 0x14, 0x22, 0x41, 0x00, 0x00, 
 // Caractere ')' (fecha parênteses)
 0x00, 0x00, 0x41, 0x22, 0x14, 0x08, 0x00, 0x00
-};
\ No newline at end of file
+};
+
+// Índice do glifo de cada caractere (em blocos de 8 bytes de font[]).
+// Zero é o glifo vazio, usado para os caracteres sem desenho
+static const uint8_t font_glyph[256] = {
+  ['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5, ['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+  ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16, ['G'] = 17, ['H'] = 18, ['I'] = 19, ['J'] = 20, ['K'] = 21, ['L'] = 22, ['M'] = 23,
+  ['N'] = 24, ['O'] = 25, ['P'] = 26, ['Q'] = 27, ['R'] = 28, ['S'] = 29, ['T'] = 30, ['U'] = 31, ['V'] = 32, ['W'] = 33, ['X'] = 34, ['Y'] = 35, ['Z'] = 36,
+  ['a'] = 37, ['b'] = 38, ['c'] = 39, ['d'] = 40, ['e'] = 41, ['f'] = 42, ['g'] = 43, ['h'] = 44, ['i'] = 45, ['j'] = 46, ['k'] = 47, ['l'] = 48, ['m'] = 49,
+  ['n'] = 50, ['o'] = 51, ['p'] = 52, ['q'] = 53, ['r'] = 54, ['s'] = 55, ['t'] = 56, ['u'] = 57, ['v'] = 58, ['w'] = 59, ['x'] = 60, ['y'] = 61, ['z'] = 62,
+  [':'] = 63, ['/'] = 64, ['('] = 65, [')'] = 66,
+};
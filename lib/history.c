@@ -0,0 +1,101 @@
+/*
+O arquivo history.c implementa o histórico de amostras.
+A soma da janela é atualizada com a amostra que entra e a que sai. Mínimo e máximo usam filas
+monotônicas: cada amostra entra e sai de cada fila no máximo uma vez.
+*/
+
+#include "history.h"
+
+void history_init(history_t *history, uint8_t ema_shift) {
+  history->total = 0;
+  history->count = 0;
+  history->sum = 0;
+  history->ema = 0;
+  history->ema_shift = ema_shift;
+  history->min_head = history->min_len = 0;
+  history->max_head = history->max_len = 0;
+}
+
+// Insere number no fim da fila, removendo antes os candidatos que ele domina
+static void queue_push(const history_t *history, uint32_t *queue, uint16_t head, uint16_t *len,
+                       uint32_t number, bool is_min) {
+  int16_t value = history_at(history, number);
+
+  while (*len) {
+    int16_t back = history_at(history, queue[(head + *len - 1) % HISTORY_CAPACITY]);
+    if (is_min ? back < value : back > value)
+      break;
+    --*len;
+  }
+
+  queue[(head + *len) % HISTORY_CAPACITY] = number;
+  ++*len;
+}
+
+// Descarta do início da fila as amostras que saíram da janela
+static void queue_expire(uint32_t *queue, uint16_t *head, uint16_t *len, uint32_t oldest) {
+  while (*len && queue[*head] < oldest) {
+    *head = (*head + 1) % HISTORY_CAPACITY;
+    --*len;
+  }
+}
+
+void history_push(history_t *history, int16_t value) {
+  uint16_t slot = history->total % HISTORY_CAPACITY;
+
+  // Com a janela cheia, a amostra mais antiga é substituída
+  if (history->count == HISTORY_CAPACITY)
+    history->sum -= history->samples[slot];
+  else
+    history->count++;
+
+  history->samples[slot] = value;
+  history->sum += value;
+
+  int32_t scaled = (int32_t)value * (1 << HISTORY_EMA_FRAC_BITS);
+  if (history->total == 0)
+    history->ema = scaled;
+  else
+    history->ema += (scaled - history->ema) >> history->ema_shift;
+
+  uint32_t number = history->total++;
+  uint32_t oldest = history->total - history->count;
+
+  queue_expire(history->min_queue, &history->min_head, &history->min_len, oldest);
+  queue_expire(history->max_queue, &history->max_head, &history->max_len, oldest);
+  queue_push(history, history->min_queue, history->min_head, &history->min_len, number, true);
+  queue_push(history, history->max_queue, history->max_head, &history->max_len, number, false);
+}
+
+uint32_t history_total(const history_t *history) {
+  return history->total;
+}
+
+uint16_t history_count(const history_t *history) {
+  return history->count;
+}
+
+// Amostra de número number; válida entre history_total - history_count e history_total - 1
+int16_t history_at(const history_t *history, uint32_t number) {
+  return history->samples[number % HISTORY_CAPACITY];
+}
+
+int16_t history_latest(const history_t *history) {
+  return history->count ? history_at(history, history->total - 1) : 0;
+}
+
+int16_t history_min(const history_t *history) {
+  return history->min_len ? history_at(history, history->min_queue[history->min_head]) : 0;
+}
+
+int16_t history_max(const history_t *history) {
+  return history->max_len ? history_at(history, history->max_queue[history->max_head]) : 0;
+}
+
+int16_t history_mean(const history_t *history) {
+  return history->count ? history->sum / history->count : 0;
+}
+
+int16_t history_ema(const history_t *history) {
+  return history->ema >> HISTORY_EMA_FRAC_BITS;
+}
@@ -0,0 +1,45 @@
+/*
+O arquivo history.h declara o histórico de amostras em buffer circular.
+Inserir uma amostra custa O(1) (amortizado para mínimo e máximo) e as estatísticas da janela
+(mínimo, máximo, média e média móvel exponencial) são mantidas incrementalmente.
+*/
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include "pico/stdlib.h"
+
+// Número de amostras guardadas (a janela das estatísticas)
+#define HISTORY_CAPACITY 128
+
+// Bits fracionários da média exponencial
+#define HISTORY_EMA_FRAC_BITS 8
+
+typedef struct {
+  int16_t samples[HISTORY_CAPACITY];
+  uint32_t total;     // amostras inseridas desde o início; a próxima tem este número
+  uint16_t count;     // amostras válidas na janela
+  int32_t sum;
+  int32_t ema;        // em 1/2^HISTORY_EMA_FRAC_BITS
+  uint8_t ema_shift;  // peso da amostra nova: 1/2^ema_shift
+
+  // Filas monotônicas com os números das amostras candidatas a mínimo e máximo
+  uint32_t min_queue[HISTORY_CAPACITY];
+  uint32_t max_queue[HISTORY_CAPACITY];
+  uint16_t min_head, min_len;
+  uint16_t max_head, max_len;
+} history_t;
+
+void history_init(history_t *history, uint8_t ema_shift);
+void history_push(history_t *history, int16_t value);
+
+uint32_t history_total(const history_t *history);
+uint16_t history_count(const history_t *history);
+int16_t history_at(const history_t *history, uint32_t number);
+int16_t history_latest(const history_t *history);
+int16_t history_min(const history_t *history);
+int16_t history_max(const history_t *history);
+int16_t history_mean(const history_t *history);
+int16_t history_ema(const history_t *history);
+
+#endif
@@ -0,0 +1,200 @@
+/*
+O arquivo input.c implementa o subsistema de entrada dos botões.
+A interrupção do GPIO registra cada borda com o instante em que chegou e (re)arma o alarme de
+debounce do botão. O alarme vence debounce_us depois da última borda, lê o nível estável e,
+se mudou, gera o evento; enquanto o botão continua pressionado o mesmo alarme marca o toque
+longo e as repetições. As duas filas têm um produtor e um consumidor cada: bordas (GPIO para
+alarme, ambos no núcleo 0 e na mesma prioridade) e eventos (alarme para o código principal).
+*/
+
+#include "input.h"
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+
+// Borda bruta: botão, eventos informados pelo GPIO e instante da interrupção
+typedef struct {
+  uint8_t button;
+  uint8_t events;
+  uint32_t time_us;
+} input_edge_t;
+
+typedef struct {
+  uint gpio;
+  bool pressed;            // nível confirmado pelo debounce
+  bool held;               // toque longo já sinalizado
+  bool bursting;           // há bordas ainda não confirmadas
+  uint32_t first_edge_us;  // primeira borda da rajada atual
+  alarm_id_t alarm;        // 0 = sem alarme pendente
+} input_button_t;
+
+static input_button_t buttons[INPUT_MAX_BUTTONS];
+static uint8_t button_count;
+static uint32_t debounce_us, long_press_us, repeat_us;
+static input_notify_t notify;
+
+static input_edge_t edges[INPUT_EDGE_QUEUE_SIZE];
+static volatile uint32_t edge_head, edge_tail;
+
+static input_event_t events[INPUT_EVENT_QUEUE_SIZE];
+static volatile uint32_t event_head, event_tail;
+
+static input_stats_t stats;
+
+// Configura os tempos de debounce, toque longo (0 desliga) e repetição (0 desliga).
+// notify é chamada a cada evento novo, por exemplo para disparar a tarefa que os consome
+void input_init(uint32_t debounce, uint32_t long_press_ms, uint32_t repeat_ms, input_notify_t callback) {
+  debounce_us = debounce;
+  long_press_us = long_press_ms * 1000;
+  repeat_us = repeat_ms * 1000;
+  notify = callback;
+  button_count = 0;
+  edge_head = edge_tail = 0;
+  event_head = event_tail = 0;
+  input_reset_stats();
+}
+
+// Coloca um evento na fila (alarme, produtor)
+static void input_emit(uint8_t button, input_event_type_t type, uint32_t edge_us, uint32_t now) {
+  uint32_t head = event_head;
+  if (head - event_tail >= INPUT_EVENT_QUEUE_SIZE) {
+    stats.dropped_events++;
+    return;
+  }
+
+  events[head % INPUT_EVENT_QUEUE_SIZE] = (input_event_t){button, type, edge_us, now};
+  __dmb();
+  event_head = head + 1;
+  stats.events++;
+
+  if (notify)
+    notify();
+}
+
+// Passa as bordas registradas pela interrupção para o estado de cada botão (alarme, consumidor)
+static void input_drain_edges(void) {
+  uint32_t head = edge_head;
+  __dmb();
+  for (uint32_t tail = edge_tail; tail != head; ++tail) {
+    const input_edge_t *edge = &edges[tail % INPUT_EDGE_QUEUE_SIZE];
+    input_button_t *b = &buttons[edge->button];
+    if (b->bursting) {
+      stats.bounces++;
+    } else {
+      b->bursting = true;
+      b->first_edge_us = edge->time_us;
+    }
+  }
+  __dmb();
+  edge_tail = head;
+}
+
+// Alarme do botão: confirma o nível depois do debounce ou marca o toque longo e as repetições.
+// Retorna em quanto tempo deve voltar (0 encerra)
+static int64_t input_settle(alarm_id_t id, void *user_data) {
+  (void)id;
+  uint8_t index = (uint8_t)(uintptr_t)user_data;
+  input_button_t *b = &buttons[index];
+  uint32_t now = time_us_32();
+
+  input_drain_edges();
+
+  // Botões com pull-up: pressionado é nível baixo
+  bool pressed = !gpio_get(b->gpio);
+  if (b->bursting) {
+    b->bursting = false;
+    if (pressed != b->pressed) {
+      b->pressed = pressed;
+      b->held = false;
+      input_emit(index, pressed ? INPUT_PRESS : INPUT_RELEASE, b->first_edge_us, now);
+    } else {
+      // A rajada voltou ao nível anterior: foi só ruído
+      stats.bounces++;
+    }
+  } else if (pressed && b->pressed) {
+    input_emit(index, b->held ? INPUT_REPEAT : INPUT_LONG_PRESS, now, now);
+    b->held = true;
+  }
+
+  if (b->pressed && long_press_us && !(b->held && !repeat_us))
+    return b->held ? repeat_us : long_press_us;
+
+  b->alarm = 0;
+  return 0;
+}
+
+// Interrupção do GPIO: só registra a borda e adia o alarme para debounce_us depois dela
+static void input_gpio_irq(uint gpio, uint32_t mask) {
+  uint8_t index = 0;
+  while (index < button_count && buttons[index].gpio != gpio)
+    ++index;
+  if (index == button_count)
+    return;
+
+  uint32_t now = time_us_32();
+  uint32_t head = edge_head;
+  stats.edges++;
+  if (head - edge_tail >= INPUT_EDGE_QUEUE_SIZE) {
+    stats.dropped_edges++;
+  } else {
+    edges[head % INPUT_EDGE_QUEUE_SIZE] = (input_edge_t){index, (uint8_t)mask, now};
+    __dmb();
+    edge_head = head + 1;
+  }
+
+  // Cada borda nova reinicia a contagem do debounce (e interrompe a do toque longo)
+  input_button_t *b = &buttons[index];
+  if (b->alarm)
+    cancel_alarm(b->alarm);
+  b->alarm = add_alarm_in_us(debounce_us, input_settle, (void *)(uintptr_t)index, true);
+}
+
+// Registra um botão ligado ao GND com pull-up interno. Retorna o índice usado nos eventos,
+// ou -1 se não houver espaço
+int input_add_button(uint gpio) {
+  if (button_count >= INPUT_MAX_BUTTONS)
+    return -1;
+
+  gpio_init(gpio);
+  gpio_set_dir(gpio, GPIO_IN);
+  gpio_pull_up(gpio);
+
+  buttons[button_count] = (input_button_t){gpio, false, false, false, 0, 0};
+  gpio_set_irq_enabled_with_callback(gpio, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, input_gpio_irq);
+  return button_count++;
+}
+
+// Retira o evento mais antigo (código principal, consumidor) e registra a latência desde a borda
+bool input_pop(input_event_t *event) {
+  uint32_t tail = event_tail;
+  if (tail == event_head)
+    return false;
+
+  __dmb();
+  *event = events[tail % INPUT_EVENT_QUEUE_SIZE];
+  __dmb();
+  event_tail = tail + 1;
+
+  uint32_t now = time_us_32();
+  uint32_t latency = now - event->edge_us;
+  uint32_t queued = now - event->queued_us;
+  stats.handled++;
+  stats.latency_sum_us += latency;
+  if (latency > stats.latency_max_us)
+    stats.latency_max_us = latency;
+  if (queued > stats.queue_max_us)
+    stats.queue_max_us = queued;
+  return true;
+}
+
+// Estado confirmado do botão (depois do debounce)
+bool input_pressed(uint8_t button) {
+  return button < button_count && buttons[button].pressed;
+}
+
+void input_get_stats(input_stats_t *out) {
+  *out = stats;
+}
+
+void input_reset_stats(void) {
+  stats = (input_stats_t){0};
+}
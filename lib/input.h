@@ -0,0 +1,58 @@
+/*
+O arquivo input.h declara o subsistema de entrada dos botões.
+A interrupção do GPIO só registra as bordas brutas numa fila sem travas; um alarme confirma o
+nível depois do debounce e gera eventos tipados (pressionar, soltar, toque longo e repetição)
+numa segunda fila, consumida pelo código principal.
+*/
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "pico/stdlib.h"
+
+// Número máximo de botões
+#define INPUT_MAX_BUTTONS 4
+
+// Posições das filas de bordas brutas e de eventos (potências de 2)
+#define INPUT_EDGE_QUEUE_SIZE 32
+#define INPUT_EVENT_QUEUE_SIZE 16
+
+typedef enum {
+  INPUT_PRESS,
+  INPUT_RELEASE,
+  INPUT_LONG_PRESS,  // botão mantido por long_press_ms
+  INPUT_REPEAT,      // a cada repeat_ms depois do toque longo
+} input_event_type_t;
+
+typedef struct {
+  uint8_t button;           // índice devolvido por input_add_button
+  input_event_type_t type;
+  uint32_t edge_us;         // primeira borda da transição (interrupção do GPIO)
+  uint32_t queued_us;       // evento confirmado e colocado na fila
+} input_event_t;
+
+// Chamada (em contexto de interrupção) sempre que um evento entra na fila
+typedef void (*input_notify_t)(void);
+
+typedef struct {
+  uint32_t edges;           // bordas recebidas pela interrupção
+  uint32_t bounces;         // bordas descartadas pelo debounce
+  uint32_t events;
+  uint32_t dropped_edges;   // fila de bordas cheia
+  uint32_t dropped_events;  // fila de eventos cheia: o código principal estava atrasado
+  // Latência da borda até o evento ser tratado (input_pop), já incluindo o debounce
+  uint32_t handled;
+  uint32_t latency_max_us;
+  uint64_t latency_sum_us;
+  // Parte da latência passada na fila de eventos, esperando o código principal
+  uint32_t queue_max_us;
+} input_stats_t;
+
+void input_init(uint32_t debounce_us, uint32_t long_press_ms, uint32_t repeat_ms, input_notify_t notify);
+int input_add_button(uint gpio);
+bool input_pop(input_event_t *event);
+bool input_pressed(uint8_t button);
+void input_get_stats(input_stats_t *stats);
+void input_reset_stats(void);
+
+#endif
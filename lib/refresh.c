@@ -0,0 +1,73 @@
+/*
+O arquivo refresh.c implementa o controle de atualização da interface.
+As taxas são dadas em milihertz para permitir, por exemplo, um quadro completo a cada 10 s.
+*/
+
+#include <string.h>
+#include "refresh.h"
+
+static inline uint32_t refresh_interval_us(uint32_t rate_mhz) {
+  return rate_mhz ? 1000000000u / rate_mhz : 0;
+}
+
+void refresh_init(refresh_governor_t *governor, uint32_t min_rate_mhz, uint32_t max_rate_mhz) {
+  memset(governor, 0, sizeof(*governor));
+  refresh_set_rates(governor, min_rate_mhz, max_rate_mhz);
+}
+
+// Taxa mínima (0 desliga os quadros forçados) e máxima (0 não limita)
+void refresh_set_rates(refresh_governor_t *governor, uint32_t min_rate_mhz, uint32_t max_rate_mhz) {
+  governor->max_interval_us = refresh_interval_us(min_rate_mhz);
+  governor->min_interval_us = refresh_interval_us(max_rate_mhz);
+}
+
+// Decide o que fazer com o quadro atual, dado se o modelo da tela mudou desde a última
+// avaliação. Uma mudança adiada continua valendo nas avaliações seguintes
+refresh_action_t refresh_frame(refresh_governor_t *governor, bool changed, uint32_t now_us) {
+  refresh_stats_t *stats = &governor->stats;
+  uint32_t elapsed = now_us - governor->last_us;
+  stats->evaluated++;
+  governor->pending |= changed;
+
+  refresh_action_t action = REFRESH_SKIP;
+  if (!governor->started) {
+    action = REFRESH_FULL;
+  } else if (governor->pending && elapsed >= governor->min_interval_us) {
+    action = REFRESH_RENDER;
+  } else if (governor->max_interval_us && elapsed >= governor->max_interval_us) {
+    action = REFRESH_FULL;
+  }
+
+  if (action == REFRESH_SKIP) {
+    stats->skipped++;
+    if (governor->pending)
+      stats->deferred++;
+    return action;
+  }
+
+  if (action == REFRESH_RENDER)
+    stats->rendered++;
+  else
+    stats->forced++;
+  governor->started = true;
+  governor->pending = false;
+  governor->last_us = now_us;
+  return action;
+}
+
+// Compara o modelo da tela com o do último quadro. Quem chama guarda o novo modelo só depois
+// de o quadro ser de fato desenhado ou entregue. Os modelos devem ser zerados antes de
+// preenchidos, para o preenchimento entre os campos não contar como mudança
+bool refresh_view_changed(const void *last, const void *view, size_t size) {
+  return memcmp(last, view, size) != 0;
+}
+
+// Fração dos quadros avaliados que não foram desenhados, em milésimos
+uint32_t refresh_skipped_permille(const refresh_governor_t *governor) {
+  const refresh_stats_t *stats = &governor->stats;
+  return stats->evaluated ? (uint32_t)((uint64_t)stats->skipped * 1000 / stats->evaluated) : 0;
+}
+
+void refresh_reset_stats(refresh_governor_t *governor) {
+  governor->stats = (refresh_stats_t){0};
+}
@@ -0,0 +1,44 @@
+/*
+O arquivo refresh.h declara o controle de atualização da interface.
+A renderização compara o modelo da tela (só o que aparece nela: números já arredondados,
+posição do quadrado, tela e brilho) com o do último quadro e só desenha quando algo mudou. O
+controlador limita a taxa de quadros a um máximo, adiando mudanças muito próximas, e garante um
+mínimo forçando um quadro completo quando a tela fica parada por tempo demais.
+*/
+
+#ifndef REFRESH_H
+#define REFRESH_H
+
+#include "pico/stdlib.h"
+
+typedef enum {
+  REFRESH_SKIP,    // nada mudou (ou a mudança foi adiada pela taxa máxima)
+  REFRESH_RENDER,  // desenhar e enviar só o que mudou
+  REFRESH_FULL,    // taxa mínima: desenhar e reenviar o quadro inteiro
+} refresh_action_t;
+
+typedef struct {
+  uint32_t evaluated;  // quadros avaliados
+  uint32_t rendered;   // quadros desenhados por mudança no modelo
+  uint32_t forced;     // quadros completos forçados pela taxa mínima
+  uint32_t skipped;    // quadros não desenhados
+  uint32_t deferred;   // dos não desenhados, os que tinham mudança adiada pela taxa máxima
+} refresh_stats_t;
+
+typedef struct {
+  uint32_t min_interval_us;  // menor intervalo entre quadros (taxa máxima)
+  uint32_t max_interval_us;  // maior intervalo sem quadro (taxa mínima); 0 nunca força
+  uint32_t last_us;          // último quadro desenhado
+  bool started;              // já houve um quadro
+  bool pending;              // mudança esperando a taxa máxima
+  refresh_stats_t stats;
+} refresh_governor_t;
+
+void refresh_init(refresh_governor_t *governor, uint32_t min_rate_mhz, uint32_t max_rate_mhz);
+void refresh_set_rates(refresh_governor_t *governor, uint32_t min_rate_mhz, uint32_t max_rate_mhz);
+refresh_action_t refresh_frame(refresh_governor_t *governor, bool changed, uint32_t now_us);
+bool refresh_view_changed(const void *last, const void *view, size_t size);
+uint32_t refresh_skipped_permille(const refresh_governor_t *governor);
+void refresh_reset_stats(refresh_governor_t *governor);
+
+#endif
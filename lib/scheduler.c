@@ -0,0 +1,204 @@
+/*
+O arquivo scheduler.c implementa o escalonador cooperativo.
+A cada passo executa a tarefa vencida de maior prioridade; sem tarefas vencidas, agenda um
+alarme para o prazo mais próximo e dorme em __wfi até ele (ou até outra interrupção).
+*/
+
+#include "scheduler.h"
+#include "hardware/sync.h"
+
+static scheduler_task_t tasks[SCHEDULER_MAX_TASKS];
+static uint task_count;
+
+// Tarefas disparadas fora do período (ex.: por interrupções), um bit por tarefa
+static volatile uint32_t triggered;
+// Tarefas habilitadas, um bit por tarefa: disparos de tarefas desabilitadas são ignorados
+static volatile uint32_t enabled_mask;
+
+// Medição do ciclo de trabalho
+static absolute_time_t stats_start;
+static uint64_t idle_us;
+static uint32_t wakeups;
+
+int scheduler_add(const char *name, scheduler_task_fn_t fn, void *data, uint32_t period_us, uint8_t priority) {
+  if (task_count >= SCHEDULER_MAX_TASKS)
+    return -1;
+
+  scheduler_task_t *task = &tasks[task_count];
+  task->name = name;
+  task->fn = fn;
+  task->data = data;
+  task->period_us = period_us;
+  task->priority = priority;
+  task->enabled = true;
+  task->deadline = period_us ? get_absolute_time() : at_the_end_of_time;
+  task->runs = 0;
+  task->overruns = 0;
+  task->busy_us = 0;
+  enabled_mask |= 1u << task_count;
+  return task_count++;
+}
+
+void scheduler_set_period(int task, uint32_t period_us) {
+  // O novo período vale a partir da execução atual, sem esperar o prazo antigo
+  absolute_time_t deadline = delayed_by_us(get_absolute_time(), period_us);
+  if (period_us < tasks[task].period_us && absolute_time_diff_us(deadline, tasks[task].deadline) > 0)
+    tasks[task].deadline = deadline;
+  tasks[task].period_us = period_us;
+}
+
+void scheduler_enable(int task, bool enabled) {
+  if (enabled && !tasks[task].enabled)
+    tasks[task].deadline = get_absolute_time();
+  tasks[task].enabled = enabled;
+
+  // Um disparo pendente de uma tarefa desabilitada nunca seria atendido e impediria o __wfi
+  uint32_t status = save_and_disable_interrupts();
+  if (enabled) {
+    enabled_mask |= 1u << task;
+  } else {
+    enabled_mask &= ~(1u << task);
+    triggered &= ~(1u << task);
+  }
+  restore_interrupts(status);
+}
+
+// Pede a execução imediata da tarefa; pode ser chamada de interrupções
+void scheduler_trigger(int task) {
+  uint32_t status = save_and_disable_interrupts();
+  triggered |= (1u << task) & enabled_mask;
+  restore_interrupts(status);
+}
+
+const scheduler_task_t *scheduler_get(int task) {
+  return &tasks[task];
+}
+
+// Zera a medição do ciclo de trabalho e o tempo de execução das tarefas
+void scheduler_reset_stats(void) {
+  stats_start = get_absolute_time();
+  idle_us = 0;
+  wakeups = 0;
+  for (uint i = 0; i < task_count; ++i)
+    tasks[i].busy_us = 0;
+}
+
+void scheduler_get_stats(scheduler_stats_t *stats) {
+  stats->elapsed_us = absolute_time_diff_us(stats_start, get_absolute_time());
+  stats->idle_us = idle_us;
+  stats->wakeups = wakeups;
+}
+
+// Fração do tempo acordado (tarefas e interrupções), em milésimos
+uint32_t scheduler_duty_permille(void) {
+  scheduler_stats_t stats;
+  scheduler_get_stats(&stats);
+  if (!stats.elapsed_us)
+    return 0;
+  return (uint32_t)((stats.elapsed_us - stats.idle_us) * 1000 / stats.elapsed_us);
+}
+
+// Escolhe a tarefa vencida de maior prioridade e informa o prazo mais próximo
+static scheduler_task_t *pick(absolute_time_t now, absolute_time_t *next_deadline) {
+  scheduler_task_t *best = NULL;
+  *next_deadline = at_the_end_of_time;
+
+  for (uint i = 0; i < task_count; ++i) {
+    scheduler_task_t *task = &tasks[i];
+    if (!task->enabled)
+      continue;
+
+    if (triggered & (1u << i))
+      task->deadline = now;
+
+    if (absolute_time_diff_us(task->deadline, now) >= 0) {
+      if (!best || task->priority > best->priority)
+        best = task;
+    } else if (absolute_time_diff_us(task->deadline, *next_deadline) > 0) {
+      *next_deadline = task->deadline;
+    }
+  }
+
+  return best;
+}
+
+static int64_t wake(alarm_id_t id, void *user_data) {
+  (void)id;
+  (void)user_data;
+  return 0;
+}
+
+// Dorme até o prazo ou até qualquer interrupção
+static void idle_until(absolute_time_t deadline) {
+  alarm_id_t alarm = 0;
+  if (!is_at_the_end_of_time(deadline)) {
+    alarm = add_alarm_at(deadline, wake, NULL, false);
+    if (alarm <= 0)
+      return;  // o prazo já passou
+  }
+
+  // Com as interrupções desligadas, uma interrupção pendente ainda acorda o __wfi,
+  // evitando dormir depois de o alarme (ou um disparo) já ter ocorrido
+  // O tempo dormindo é medido antes de reabilitar as interrupções: as rotinas que rodam ao
+  // acordar contam como tempo ativo
+  uint32_t status = save_and_disable_interrupts();
+  if (!(triggered & enabled_mask) && !time_reached(deadline)) {
+    absolute_time_t sleep_start = get_absolute_time();
+    __wfi();
+    idle_us += absolute_time_diff_us(sleep_start, get_absolute_time());
+    wakeups++;
+  }
+  restore_interrupts(status);
+
+  if (alarm > 0)
+    cancel_alarm(alarm);
+}
+
+// Executa uma tarefa vencida; retorna false se nenhuma estava pronta
+bool scheduler_run_next(void) {
+  absolute_time_t now = get_absolute_time();
+  absolute_time_t next_deadline;
+  scheduler_task_t *task = pick(now, &next_deadline);
+  if (!task)
+    return false;
+
+  uint32_t status = save_and_disable_interrupts();
+  triggered &= ~(1u << (task - tasks));
+  restore_interrupts(status);
+
+  absolute_time_t start = get_absolute_time();
+  task->fn(task->data);
+  task->busy_us += absolute_time_diff_us(start, get_absolute_time());
+  task->runs++;
+
+  // Sem período a tarefa só volta a executar quando for disparada
+  if (!task->period_us) {
+    task->deadline = at_the_end_of_time;
+    return true;
+  }
+
+  // Prazo fixo: o próximo é relativo ao anterior; se já passou, recomeça a partir de agora
+  task->deadline = delayed_by_us(task->deadline, task->period_us);
+  if (time_reached(task->deadline)) {
+    task->overruns++;
+    task->deadline = delayed_by_us(get_absolute_time(), task->period_us);
+  }
+  return true;
+}
+
+void scheduler_run_until(absolute_time_t end) {
+  while (!time_reached(end)) {
+    if (scheduler_run_next())
+      continue;
+
+    absolute_time_t next_deadline;
+    pick(get_absolute_time(), &next_deadline);
+    if (absolute_time_diff_us(end, next_deadline) > 0)
+      next_deadline = end;
+    idle_until(next_deadline);
+  }
+}
+
+void scheduler_run(void) {
+  scheduler_run_until(at_the_end_of_time);
+}
@@ -0,0 +1,51 @@
+/*
+O arquivo scheduler.h declara um escalonador cooperativo baseado em prazos.
+Cada tarefa é uma função periódica com período e prioridade próprios; com período 0 ela só
+executa quando disparada por scheduler_trigger. Entre os prazos o
+processador dorme em __wfi, acordado por um alarme do SDK ou por qualquer interrupção.
+O tempo dormindo e o tempo de cada tarefa são medidos para acompanhar o ciclo de trabalho.
+*/
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "pico/stdlib.h"
+
+#define SCHEDULER_MAX_TASKS 8
+
+typedef void (*scheduler_task_fn_t)(void *data);
+
+typedef struct {
+  const char *name;
+  scheduler_task_fn_t fn;
+  void *data;
+  uint32_t period_us;
+  uint8_t priority;          // maior valor = executa primeiro entre tarefas vencidas
+  bool enabled;
+  absolute_time_t deadline;  // próxima execução
+  uint32_t runs;
+  uint32_t overruns;         // execuções que perderam um ou mais períodos
+  uint64_t busy_us;          // tempo total executando
+} scheduler_task_t;
+
+// Ciclo de trabalho desde o último scheduler_reset_stats
+typedef struct {
+  uint64_t elapsed_us;  // tempo total medido
+  uint64_t idle_us;     // tempo dormindo em __wfi
+  uint32_t wakeups;     // vezes que o processador dormiu e acordou
+} scheduler_stats_t;
+
+int scheduler_add(const char *name, scheduler_task_fn_t fn, void *data, uint32_t period_us, uint8_t priority);
+void scheduler_set_period(int task, uint32_t period_us);
+void scheduler_enable(int task, bool enabled);
+void scheduler_trigger(int task);
+const scheduler_task_t *scheduler_get(int task);
+void scheduler_reset_stats(void);
+void scheduler_get_stats(scheduler_stats_t *stats);
+uint32_t scheduler_duty_permille(void);
+
+bool scheduler_run_next(void);
+void scheduler_run_until(absolute_time_t end);
+void scheduler_run(void);
+
+#endif
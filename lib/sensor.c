@@ -0,0 +1,92 @@
+/*
+O arquivo sensor.c implementa a tabela de canais de medição.
+sensor_update lê o último valor de cada entrada publicado pela aquisição, converte pela curva
+do canal e filtra; sensor_check_alarms passa os valores pelo motor de alarme e as funções de
+faixa resumem o estado de todos os canais.
+*/
+
+#include "sensor.h"
+#include "adc_acq.h"
+
+// Máscara de entradas do ADC para a varredura round-robin
+uint8_t sensor_input_mask(const sensor_channel_t *channels, size_t count) {
+  uint8_t mask = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (channels[i].enabled)
+      mask |= 1u << channels[i].input;
+  }
+  return mask;
+}
+
+uint8_t sensor_enabled_count(const sensor_channel_t *channels, size_t count) {
+  uint8_t enabled = 0;
+  for (size_t i = 0; i < count; ++i)
+    enabled += channels[i].enabled;
+  return enabled;
+}
+
+// Converte e filtra a leitura mais recente de cada canal habilitado
+void sensor_update(sensor_channel_t *channels, size_t count) {
+  uint8_t bits = adc_acq_bits();
+
+  for (size_t i = 0; i < count; ++i) {
+    sensor_channel_t *channel = &channels[i];
+    if (!channel->enabled)
+      continue;
+
+    int32_t sample = calib_convert(channel->calib, adc_acq_read_raw(channel->input), bits);
+
+    // O filtro começa no primeiro valor para não subir lentamente a partir de zero
+    if (!channel->primed) {
+      channel->filter_acc = sample * (1 << channel->filter_shift);
+      channel->primed = true;
+    } else {
+      channel->filter_acc += sample - (channel->filter_acc >> channel->filter_shift);
+    }
+    channel->value = channel->filter_acc >> channel->filter_shift;
+  }
+}
+
+// Avalia o alarme de cada canal habilitado que tem um, com o instante da amostra
+void sensor_check_alarms(sensor_channel_t *channels, size_t count, uint32_t sample_us) {
+  for (size_t i = 0; i < count; ++i) {
+    sensor_channel_t *channel = &channels[i];
+    if (!channel->enabled || !channel->alarm.config)
+      continue;
+
+    alarm_update(&channel->alarm, i, channel->value, sample_us);
+    channel->range = channel->alarm.state == ALARM_LOW ? SENSOR_RANGE_LOW :
+      channel->alarm.state == ALARM_HIGH ? SENSOR_RANGE_HIGH : SENSOR_RANGE_NORMAL;
+  }
+}
+
+// A mais grave entre duas faixas: alta, depois baixa
+static inline sensor_range_t sensor_worse(sensor_range_t worst, sensor_range_t range) {
+  if (range == SENSOR_RANGE_HIGH || (range == SENSOR_RANGE_LOW && worst == SENSOR_RANGE_NORMAL))
+    return range;
+  return worst;
+}
+
+// Faixa confirmada mais grave entre os canais com alarme
+sensor_range_t sensor_worst_range(const sensor_channel_t *channels, size_t count) {
+  sensor_range_t worst = SENSOR_RANGE_NORMAL;
+  for (size_t i = 0; i < count; ++i) {
+    if (channels[i].enabled && channels[i].alarm.config)
+      worst = sensor_worse(worst, channels[i].range);
+  }
+  return worst;
+}
+
+// Faixa prevista mais grave entre os canais ainda na faixa normal (normal se não há previsão)
+sensor_range_t sensor_predicted_range(const sensor_channel_t *channels, size_t count) {
+  sensor_range_t worst = SENSOR_RANGE_NORMAL;
+  for (size_t i = 0; i < count; ++i) {
+    if (!channels[i].enabled || !channels[i].alarm.config)
+      continue;
+    if (channels[i].alarm.state == ALARM_PREDICT_HIGH)
+      worst = sensor_worse(worst, SENSOR_RANGE_HIGH);
+    else if (channels[i].alarm.state == ALARM_PREDICT_LOW)
+      worst = sensor_worse(worst, SENSOR_RANGE_LOW);
+  }
+  return worst;
+}
@@ -0,0 +1,46 @@
+/*
+O arquivo sensor.h declara a tabela de canais de medição.
+Cada canal associa uma entrada do ADC a uma curva de conversão (calib.h), a um filtro
+exponencial e, opcionalmente, a uma configuração do motor de alarme (alarm.h). Todas as entradas habilitadas são convertidas na mesma
+varredura round-robin do ADC (adc_acq.h), então somar um canal não acrescenta conversões
+avulsas nem interrupções: só uma conversão e um filtro a cada amostra.
+*/
+
+#ifndef SENSOR_H
+#define SENSOR_H
+
+#include "pico/stdlib.h"
+#include "calib.h"
+#include "alarm.h"
+
+// Faixa do valor em relação aos limites do canal
+typedef enum {
+  SENSOR_RANGE_LOW,
+  SENSOR_RANGE_NORMAL,
+  SENSOR_RANGE_HIGH
+} sensor_range_t;
+
+typedef struct {
+  // Configuração
+  const char *name;
+  uint8_t input;                // entrada do ADC: 0 a 3 (GPIO 26 a 29) ou 4 (sensor interno)
+  const calib_table_t *calib;   // curva da leitura bruta para a unidade do canal
+  uint8_t filter_shift;         // média exponencial com peso 1/2^n para a amostra nova (0 = sem filtro)
+  bool enabled;
+  alarm_channel_t alarm;        // .alarm.config com os limites, na unidade da curva (NULL = sem alarme)
+
+  // Estado
+  int32_t value;                // último valor convertido e filtrado
+  int32_t filter_acc;           // acumulador do filtro: valor << filter_shift
+  bool primed;                  // o filtro já recebeu a primeira amostra
+  sensor_range_t range;
+} sensor_channel_t;
+
+uint8_t sensor_input_mask(const sensor_channel_t *channels, size_t count);
+uint8_t sensor_enabled_count(const sensor_channel_t *channels, size_t count);
+void sensor_update(sensor_channel_t *channels, size_t count);
+void sensor_check_alarms(sensor_channel_t *channels, size_t count, uint32_t sample_us);
+sensor_range_t sensor_worst_range(const sensor_channel_t *channels, size_t count);
+sensor_range_t sensor_predicted_range(const sensor_channel_t *channels, size_t count);
+
+#endif
@@ -0,0 +1,65 @@
+/*
+O arquivo snapshot.c implementa a fila de instantâneos entre os núcleos.
+Produtor e consumidor só escrevem nos próprios índices; as barreiras de memória garantem que
+o conteúdo da posição esteja visível antes do índice que a publica. O consumidor é acordado
+por __sev/__wfe, sem usar o FIFO entre núcleos (reservado ao SDK, por exemplo para gravar na flash).
+*/
+
+#include <string.h>
+#include "snapshot.h"
+#include "hardware/sync.h"
+
+void snapshot_queue_init(snapshot_queue_t *queue, void *storage, size_t size) {
+  queue->storage = storage;
+  queue->size = size;
+  queue->head = 0;
+  queue->tail = 0;
+  queue->published = 0;
+  queue->consumed = 0;
+  queue->coalesced = 0;
+}
+
+// Publica um instantâneo (núcleo produtor). Com a fila cheia a posição do mais antigo é
+// reaproveitada; ele conta como agregado quando o consumidor ler o mais recente
+void snapshot_queue_publish(snapshot_queue_t *queue, const void *snapshot) {
+  uint32_t head = queue->head;
+  memcpy(queue->storage + (head % SNAPSHOT_QUEUE_SLOTS) * queue->size, snapshot, queue->size);
+  __dmb();
+  queue->head = head + 1;
+  queue->published++;
+
+  // Acorda o outro núcleo se estiver em __wfe
+  __sev();
+}
+
+// Copia o instantâneo mais recente e descarta os anteriores (núcleo consumidor).
+// Retorna false se não havia nada novo.
+bool snapshot_queue_take_latest(snapshot_queue_t *queue, void *snapshot) {
+  uint32_t tail = queue->tail;
+  uint32_t head;
+  while (true) {
+    head = queue->head;
+    if (head == tail)
+      return false;
+
+    __dmb();
+    memcpy(snapshot, queue->storage + ((head - 1) % SNAPSHOT_QUEUE_SLOTS) * queue->size, queue->size);
+    __dmb();
+
+    // A posição copiada só volta a ser escrita quando o produtor dá a volta na fila; se ele
+    // chegou nela durante a cópia, o conteúdo pode estar misturado e a leitura é refeita
+    if (queue->head - head < SNAPSHOT_QUEUE_SLOTS - 1)
+      break;
+  }
+  queue->tail = head;
+
+  queue->consumed++;
+  queue->coalesced += head - tail - 1;
+  return true;
+}
+
+// Dorme em __wfe até haver um instantâneo novo
+void snapshot_queue_wait_latest(snapshot_queue_t *queue, void *snapshot) {
+  while (!snapshot_queue_take_latest(queue, snapshot))
+    __wfe();
+}
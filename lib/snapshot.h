@@ -0,0 +1,33 @@
+/*
+O arquivo snapshot.h declara uma fila sem travas de um produtor e um consumidor para passar
+instantâneos do estado (sensores e interface) do núcleo 0 para o núcleo 1.
+O consumidor sempre fica com o instantâneo mais recente; os intermediários são agregados.
+O produtor nunca espera nem descarta: com a fila cheia, o novo instantâneo ocupa a posição do
+mais antigo, que o consumidor não usaria.
+*/
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "pico/stdlib.h"
+
+// Número de posições da fila (potência de 2)
+#define SNAPSHOT_QUEUE_SLOTS 4
+
+typedef struct {
+  uint8_t *storage;     // SNAPSHOT_QUEUE_SLOTS posições de size bytes
+  size_t size;
+  volatile uint32_t head;  // escrito só pelo produtor
+  volatile uint32_t tail;  // escrito só pelo consumidor: último instantâneo lido
+  // Contadores de diagnóstico
+  volatile uint32_t published;
+  volatile uint32_t consumed;
+  volatile uint32_t coalesced;  // instantâneos substituídos por outro mais novo antes de serem usados
+} snapshot_queue_t;
+
+void snapshot_queue_init(snapshot_queue_t *queue, void *storage, size_t size);
+void snapshot_queue_publish(snapshot_queue_t *queue, const void *snapshot);
+bool snapshot_queue_take_latest(snapshot_queue_t *queue, void *snapshot);
+void snapshot_queue_wait_latest(snapshot_queue_t *queue, void *snapshot);
+
+#endif
@@ -0,0 +1,26 @@
+/*
+O arquivo sprites.h armazena o atlas de imagens móveis desenhadas com ssd1306_blit e os sprites.
+As imagens usam o formato de ssd1306_image_t (colunas de 8 pixels, faixa após faixa) e ficam
+na flash como a fonte.
+*/
+
+#ifndef SPRITES_H
+#define SPRITES_H
+
+#include "ssd1306.h"
+
+static const uint8_t sprite_bits[] = {
+  // Quadrado cheio 8x8 (menu do joystick)
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+// Índices das imagens no atlas
+enum {
+  SPRITE_SQUARE,
+};
+
+static const ssd1306_image_t sprite_atlas[] = {
+  [SPRITE_SQUARE] = SSD1306_IMAGE(8, 8, &sprite_bits[0], NULL),
+};
+
+#endif
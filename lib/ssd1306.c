@@ -4,17 +4,51 @@ Este arquivo é responsável por enviar comandos e dados para o display OLED SSD
 */
 
 
+#include <string.h>
 #include "ssd1306.h"
 #include "font.h"
-
-ssd1306_t ssd;
-PIO pio = pio0;
-uint offset = 0;
-uint sm = 0;
-uint32_t RED   = 0x00FF00;
-uint32_t GREEN = 0xFF0000;
-uint32_t BLUE  = 0x0000FF;
-uint32_t WHITE  = 0xFFFFFF;
+#include "timing.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+// Bytes de controle de uma janela: a transação de comandos (0x00 e seis comandos) mais o
+// byte 0x40 dos dados
+#define WINDOW_OVERHEAD (1 + 6 + 1)
+
+// Sequências de inicialização prontas para os painéis com regulador interno; as outras
+// geometrias montam a mesma sequência na pilha
+static const uint8_t ssd1306_init_64[] = SSD1306_INIT_SEQUENCE(64, false);
+static const uint8_t ssd1306_init_32[] = SSD1306_INIT_SEQUENCE(32, false);
+
+// Janela retangular de colunas x0..x1 e páginas p0..p1
+typedef struct {
+  uint8_t x0, x1, p0, p1;
+} ssd1306_window_t;
+
+// Barramento I2C compartilhado: os quadros assíncronos dos painéis entram numa fila e são
+// transmitidos em sequência pelas interrupções, sem voltar ao laço principal entre eles
+typedef struct {
+  i2c_inst_t *i2c;
+  ssd1306_t *volatile active;               // painel com DMA em andamento
+  ssd1306_t *queue[SSD1306_BUS_MAX_PANELS];
+  volatile uint8_t head, count;
+  volatile bool switching;                  // esperando o STOP para trocar o endereço
+  ssd1306_bus_stats_t stats;
+#if TIMING
+  uint32_t frame_start_us;                  // disparo do quadro ativo
+#endif
+} ssd1306_bus_t;
+
+// Etapas medidas com TIMING=1: envio bloqueante, quadro inteiro, codificação para o DMA e
+// tempo de um quadro no barramento (do disparo do DMA até a interrupção de fim)
+TIMING_STAGE(etapa_envio, "ssd1306 envio");
+TIMING_STAGE(etapa_tela, "ssd1306 tela");
+TIMING_STAGE(etapa_codifica, "ssd1306 codifica");
+TIMING_STAGE(etapa_barramento, "ssd1306 i2c");
+
+// Display dono de cada canal de DMA, usado pela interrupção de fim de transferência
+static ssd1306_t *dma_owner[NUM_DMA_CHANNELS];
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
   ssd->width = width;
@@ -26,136 +60,570 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
   ssd->bufsize = ssd->pages * ssd->width + 1;
   ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
   ssd->ram_buffer[0] = 0x40;
-  ssd->port_buffer[0] = 0x80;
+  ssd->command_buffer[0] = 0x00;
+  ssd->transactions = 0;
+  ssd->shadow_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd->window_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd->window_buffer[0] = 0x40;
+  ssd->shadow_valid = false;
+  ssd->dirty_pages = 0;
+  ssd->tx_buffer = NULL;
+  ssd->dma_chan = -1;
+  ssd->busy = false;
+  ssd->callback = NULL;
+  ssd->callback_data = NULL;
+}
+
+// Índice do byte que guarda a coluna x da página informada (modo de endereçamento vertical)
+static inline uint16_t ssd1306_index(const ssd1306_t *ssd, uint8_t x, uint8_t page) {
+  return x * ssd->pages + page + 1;
+}
+
+// Marca as colunas x0..x1 da página como alteradas
+static inline void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page) {
+  uint8_t bit = 1u << page;
+  if (ssd->dirty_pages & bit) {
+    if (x0 < ssd->dirty_x0[page]) ssd->dirty_x0[page] = x0;
+    if (x1 > ssd->dirty_x1[page]) ssd->dirty_x1[page] = x1;
+  } else {
+    ssd->dirty_pages |= bit;
+    ssd->dirty_x0[page] = x0;
+    ssd->dirty_x1[page] = x1;
+  }
 }
 
+static inline void ssd1306_mark_all_dirty(ssd1306_t *ssd) {
+  for (uint8_t page = 0; page < ssd->pages; ++page)
+    ssd1306_mark_dirty(ssd, 0, ssd->width - 1, page);
+}
+
+// Envia a sequência de inicialização inteira numa única transação
 void ssd1306_config(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_DISP | 0x00);
-  ssd1306_command(ssd, SET_MEM_ADDR);
-  ssd1306_command(ssd, 0x01);
-  ssd1306_command(ssd, SET_DISP_START_LINE | 0x00);
-  ssd1306_command(ssd, SET_SEG_REMAP | 0x01);
-  ssd1306_command(ssd, SET_MUX_RATIO);
-  ssd1306_command(ssd, HEIGHT - 1);
-  ssd1306_command(ssd, SET_COM_OUT_DIR | 0x08);
-  ssd1306_command(ssd, SET_DISP_OFFSET);
-  ssd1306_command(ssd, 0x00);
-  ssd1306_command(ssd, SET_COM_PIN_CFG);
-  ssd1306_command(ssd, 0x12);
-  ssd1306_command(ssd, SET_DISP_CLK_DIV);
-  ssd1306_command(ssd, 0x80);
-  ssd1306_command(ssd, SET_PRECHARGE);
-  ssd1306_command(ssd, 0xF1);
-  ssd1306_command(ssd, SET_VCOM_DESEL);
-  ssd1306_command(ssd, 0x30);
-  ssd1306_command(ssd, SET_CONTRAST);
-  ssd1306_command(ssd, 0xFF);
-  ssd1306_command(ssd, SET_ENTIRE_ON);
-  ssd1306_command(ssd, SET_NORM_INV);
-  ssd1306_command(ssd, SET_CHARGE_PUMP);
-  ssd1306_command(ssd, 0x14);
-  ssd1306_command(ssd, SET_DISP | 0x01);
-}
-
-// Inicializa a Matriz WS2812
-void init_matrix() {
-  offset = pio_add_program(pio, &ws2812_program);
-  sm = pio_claim_unused_sm(pio, true);
-  ws2812_program_init(pio, sm, offset, MATRIX_PIN, 800000, false);
-}
-
-// Define a cor da matriz
-void set_matrix_color(uint32_t color) {
-    float brilho = 0.2f; // Valor máxido de 1
-
-    // Extrai os componentes GRB
-    uint8_t g = (color >> 16) & 0xFF;
-    uint8_t r = (color >> 8) & 0xFF;
-    uint8_t b = color & 0xFF;
-
-    // Aplica o fator de brilho
-    g = (uint8_t)(g * brilho);
-    r = (uint8_t)(r * brilho);
-    b = (uint8_t)(b * brilho);
-
-    // Recombina no formato GRB
-    uint32_t cor = (g << 16) | (r << 8) | b;
-
-    // Envia para todos os LEDs da matriz
-    for (int i = 0; i < NUM_LEDS; i++) {
-        ws2812_put_pixel(cor);
-    }
+  if (!ssd->external_vcc && ssd->height == 64) {
+    ssd1306_command_list(ssd, ssd1306_init_64, sizeof(ssd1306_init_64));
+  } else if (!ssd->external_vcc && ssd->height == 32) {
+    ssd1306_command_list(ssd, ssd1306_init_32, sizeof(ssd1306_init_32));
+  } else {
+    const uint8_t sequence[] = SSD1306_INIT_SEQUENCE(ssd->height, ssd->external_vcc);
+    ssd1306_command_list(ssd, sequence, sizeof(sequence));
+  }
+}
+
+// Ajusta o brilho do painel: 0x00 é o mínimo e 0xFF o valor usado na configuração
+void ssd1306_set_contrast(ssd1306_t *ssd, uint8_t contrast) {
+  const uint8_t commands[] = {SET_CONTRAST, contrast};
+  ssd1306_command_list(ssd, commands, sizeof(commands));
 }
 
-void ws2812_put_pixel(uint32_t pixel_grb) {
-  // Aguarda o FIFO estar disponível
-  while (pio_sm_is_tx_fifo_full(pio, sm));
-  // Envia os bits do pixel no formato GRB
-  pio_sm_put_blocking(pio, sm, pixel_grb << 8u);
+// Liga ou desliga o painel (modo sleep do SSD1306); a RAM do display é preservada
+void ssd1306_set_power(ssd1306_t *ssd, bool on) {
+  ssd1306_command(ssd, SET_DISP | (on ? 0x01 : 0x00));
 }
 
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
-  ssd->port_buffer[1] = command;
+  ssd1306_command_list(ssd, &command, 1);
+}
+
+// Envia uma sequência de comandos (com seus parâmetros) numa única transação: um só byte de
+// controle 0x00 (Co = 0, D/C = 0) vale para todos os bytes seguintes
+void ssd1306_command_list(ssd1306_t *ssd, const uint8_t *commands, size_t count) {
+  // O barramento precisa estar livre de transferências assíncronas
+  ssd1306_send_wait(ssd);
+  while (count) {
+    size_t chunk = count < SSD1306_COMMAND_LIST_MAX ? count : SSD1306_COMMAND_LIST_MAX;
+    memcpy(ssd->command_buffer + 1, commands, chunk);
+    i2c_write_blocking(
+      ssd->i2c_port,
+      ssd->address,
+      ssd->command_buffer,
+      chunk + 1,
+      false
+    );
+    ssd->transactions++;
+    commands += chunk;
+    count -= chunk;
+  }
+}
+
+// Define a janela de colunas x0..x1 e páginas p0..p1 que os próximos dados preenchem
+static inline void ssd1306_set_window(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1) {
+  const uint8_t commands[] = {SET_COL_ADDR, x0, x1, SET_PAGE_ADDR, p0, p1};
+  ssd1306_command_list(ssd, commands, sizeof(commands));
+}
+
+// Envia o buffer inteiro e retorna a quantidade de bytes transmitidos no barramento
+size_t ssd1306_send_data(ssd1306_t *ssd) {
+  TIMING_BEGIN(start);
+  ssd1306_set_window(ssd, 0, ssd->width - 1, 0, ssd->pages - 1);
   i2c_write_blocking(
     ssd->i2c_port,
     ssd->address,
-    ssd->port_buffer,
-    2,
+    ssd->ram_buffer,
+    ssd->bufsize,
     false
   );
+  ssd->transactions++;
+
+  // O painel agora está idêntico ao buffer
+  memcpy(ssd->shadow_buffer, ssd->ram_buffer, ssd->bufsize);
+  ssd->shadow_valid = true;
+  ssd->dirty_pages = 0;
+
+  TIMING_END(etapa_tela, start);
+  return WINDOW_OVERHEAD - 1 + ssd->bufsize;
+}
+
+// Calcula as janelas a enviar a partir das regiões sujas e retorna quantas foram geradas
+static uint8_t ssd1306_plan_windows(ssd1306_t *ssd, ssd1306_window_t *windows) {
+  // Sem uma cópia confiável do painel não há como comparar: envia tudo
+  if (!ssd->shadow_valid) {
+    windows[0] = (ssd1306_window_t){0, ssd->width - 1, 0, ssd->pages - 1};
+    ssd->shadow_valid = true;
+    ssd->dirty_pages = 0;
+    return 1;
+  }
+
+  size_t split_cost = 0;
+  uint8_t p_min = 0xFF, p_max = 0, x_min = 0xFF, x_max = 0;
+
+  // Reduz cada intervalo sujo às colunas que realmente diferem do painel
+  for (uint8_t page = 0; page < ssd->pages; ++page) {
+    if (!(ssd->dirty_pages & (1u << page)))
+      continue;
+
+    uint8_t x0 = ssd->dirty_x0[page];
+    uint8_t x1 = ssd->dirty_x1[page];
+    while (x0 <= x1 && ssd->ram_buffer[ssd1306_index(ssd, x0, page)] == ssd->shadow_buffer[ssd1306_index(ssd, x0, page)])
+      ++x0;
+    while (x1 > x0 && ssd->ram_buffer[ssd1306_index(ssd, x1, page)] == ssd->shadow_buffer[ssd1306_index(ssd, x1, page)])
+      --x1;
+
+    if (x0 > x1) {
+      ssd->dirty_pages &= ~(1u << page);
+      continue;
+    }
+
+    ssd->dirty_x0[page] = x0;
+    ssd->dirty_x1[page] = x1;
+    split_cost += WINDOW_OVERHEAD + (x1 - x0 + 1);
+    if (page < p_min) p_min = page;
+    if (page > p_max) p_max = page;
+    if (x0 < x_min) x_min = x0;
+    if (x1 > x_max) x_max = x1;
+  }
+
+  if (!ssd->dirty_pages)
+    return 0;
+
+  // Escolhe entre uma janela por página ou uma única janela envolvendo todas
+  size_t merged_cost = WINDOW_OVERHEAD + (size_t)(x_max - x_min + 1) * (p_max - p_min + 1);
+  uint8_t count = 0;
+
+  if (merged_cost <= split_cost) {
+    windows[count++] = (ssd1306_window_t){x_min, x_max, p_min, p_max};
+  } else {
+    for (uint8_t page = p_min; page <= p_max; ++page) {
+      if (ssd->dirty_pages & (1u << page))
+        windows[count++] = (ssd1306_window_t){ssd->dirty_x0[page], ssd->dirty_x1[page], page, page};
+    }
+  }
+
+  ssd->dirty_pages = 0;
+  return count;
 }
 
-void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
+// Envia uma janela de forma bloqueante e retorna os bytes transmitidos
+static size_t ssd1306_send_window(ssd1306_t *ssd, const ssd1306_window_t *w) {
+  size_t len = 1;
+
+  // No endereçamento vertical o painel percorre as páginas de cada coluna em sequência
+  for (uint8_t x = w->x0; x <= w->x1; ++x) {
+    for (uint8_t page = w->p0; page <= w->p1; ++page) {
+      uint16_t index = ssd1306_index(ssd, x, page);
+      ssd->window_buffer[len++] = ssd->ram_buffer[index];
+      ssd->shadow_buffer[index] = ssd->ram_buffer[index];
+    }
+  }
+
+  ssd1306_set_window(ssd, w->x0, w->x1, w->p0, w->p1);
   i2c_write_blocking(
     ssd->i2c_port,
     ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
+    ssd->window_buffer,
+    len,
     false
   );
+  ssd->transactions++;
+
+  return WINDOW_OVERHEAD - 1 + len;
+}
+
+// Envia apenas as regiões alteradas desde o último envio e retorna os bytes transmitidos
+size_t ssd1306_send_dirty(ssd1306_t *ssd) {
+  TIMING_BEGIN(start);
+  ssd1306_window_t windows[SSD1306_MAX_PAGES];
+  uint8_t count = ssd1306_plan_windows(ssd, windows);
+  size_t sent = 0;
+
+  for (uint8_t i = 0; i < count; ++i)
+    sent += ssd1306_send_window(ssd, &windows[i]);
+
+  TIMING_END(etapa_envio, start);
+  return sent;
+}
+
+// Esquece a cópia do painel: o próximo envio manda o quadro inteiro, o que também corrige um
+// painel que perdeu o conteúdo sem o driver perceber (queda de alimentação, ruído no barramento)
+void ssd1306_invalidate(ssd1306_t *ssd) {
+  ssd->shadow_valid = false;
+}
+
+// Um NACK descarta o FIFO de transmissão: o conteúdo do painel passa a ser desconhecido
+static void ssd1306_check_abort(ssd1306_t *ssd) {
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+    (void)hw->clr_tx_abrt;
+    ssd->shadow_valid = false;
+  }
+}
+
+// Estado de um barramento I2C compartilhado pelos painéis com envio assíncrono
+static ssd1306_bus_t buses[NUM_I2CS];
+
+static inline ssd1306_bus_t *ssd1306_bus(ssd1306_t *ssd) {
+  return &buses[i2c_get_index(ssd->i2c_port)];
+}
+
+// O controlador terminou de transmitir tudo o que estava no FIFO
+static inline bool ssd1306_bus_idle(i2c_hw_t *hw) {
+  return (hw->status & I2C_IC_STATUS_TFE_BITS) && !(hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS);
+}
+
+// Passa ao próximo painel da fila. Chamada com interrupções desabilitadas ou de dentro delas,
+// sempre sem DMA em andamento no barramento
+static void ssd1306_bus_next(ssd1306_bus_t *bus) {
+  bus->active = NULL;
+  if (!bus->count)
+    return;
+
+  ssd1306_t *next = bus->queue[bus->head];
+  i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+
+  if (hw->tar != next->address) {
+    // Trocar o endereço de destino exige o controlador parado: espera o STOP da última
+    // transação. O flag é limpo antes de conferir o estado para não perder um STOP no meio
+    (void)hw->clr_stop_det;
+    if (!ssd1306_bus_idle(hw)) {
+      bus->switching = true;
+      hw->intr_mask |= I2C_IC_INTR_MASK_M_STOP_DET_BITS;
+      return;
+    }
+    hw->enable = 0;
+    hw->tar = next->address;
+    hw->enable = 1;
+    bus->stats.switches++;
+  }
+
+  // Com o mesmo endereço as palavras do próximo quadro seguem direto no FIFO
+  bus->head = (bus->head + 1) % SSD1306_BUS_MAX_PANELS;
+  bus->count--;
+  bus->active = next;
+  bus->stats.frames++;
+#if TIMING
+  bus->frame_start_us = time_us_32();
+#endif
+  dma_channel_transfer_from_buffer_now(next->dma_chan, next->tx_buffer, next->tx_len);
+}
+
+// Coloca um quadro já codificado na fila do barramento
+static inline void ssd1306_bus_enqueue(ssd1306_t *ssd) {
+  ssd1306_bus_t *bus = ssd1306_bus(ssd);
+  bus->queue[(bus->head + bus->count) % SSD1306_BUS_MAX_PANELS] = ssd;
+  bus->count++;
+}
+
+// Se o barramento estava parado, uma nova sessão começa; senão os quadros da fila saem
+// logo depois dos que estão na frente
+static inline void ssd1306_bus_kick(ssd1306_bus_t *bus) {
+  if (!bus->active && !bus->switching && bus->count) {
+    bus->stats.sessions++;
+    ssd1306_bus_next(bus);
+  }
+}
+
+static void ssd1306_dma_irq_handler(void) {
+  for (uint channel = 0; channel < NUM_DMA_CHANNELS; ++channel) {
+    ssd1306_t *ssd = dma_owner[channel];
+    if (!ssd || !dma_channel_get_irq0_status(channel))
+      continue;
+
+    dma_channel_acknowledge_irq0(channel);
+    ssd1306_check_abort(ssd);
+    ssd->busy = false;
+    if (ssd->callback)
+      ssd->callback(ssd->callback_data);
+
+    ssd1306_bus_t *bus = ssd1306_bus(ssd);
+    if (bus->active == ssd) {
+      TIMING_RECORD(etapa_barramento, time_us_32() - bus->frame_start_us);
+      ssd1306_bus_next(bus);
+    }
+  }
+}
+
+// STOP no barramento enquanto um painel espera para trocar o endereço de destino
+static void ssd1306_i2c_irq_handler(void) {
+  for (uint i = 0; i < NUM_I2CS; ++i) {
+    ssd1306_bus_t *bus = &buses[i];
+    if (!bus->switching)
+      continue;
+
+    i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+    (void)hw->clr_stop_det;
+    if (!ssd1306_bus_idle(hw))
+      continue;
+
+    hw->intr_mask &= ~I2C_IC_INTR_MASK_M_STOP_DET_BITS;
+    bus->switching = false;
+    ssd1306_bus_next(bus);
+  }
+}
+
+// Prepara o envio assíncrono: um canal de DMA alimenta o FIFO de transmissão do I2C.
+// Até SSD1306_BUS_MAX_PANELS painéis podem dividir o mesmo barramento
+void ssd1306_async_init(ssd1306_t *ssd) {
+  static bool irq_installed = false;
+
+  // Cada byte vira uma palavra no formato do registrador IC_DATA_CMD (bit 9 = STOP)
+  ssd->tx_buffer = calloc(WINDOW_OVERHEAD + ssd->pages * ssd->width, sizeof(uint16_t));
+  ssd->tx_len = 0;
+  ssd->dma_chan = dma_claim_unused_channel(true);
+
+  dma_channel_config config = dma_channel_get_default_config(ssd->dma_chan);
+  channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+  channel_config_set_read_increment(&config, true);
+  channel_config_set_write_increment(&config, false);
+  channel_config_set_dreq(&config, i2c_get_dreq(ssd->i2c_port, true));
+  dma_channel_configure(
+    ssd->dma_chan,
+    &config,
+    &i2c_get_hw(ssd->i2c_port)->data_cmd,
+    ssd->tx_buffer,
+    0,
+    false
+  );
+
+  dma_owner[ssd->dma_chan] = ssd;
+  dma_channel_set_irq0_enabled(ssd->dma_chan, true);
+  if (!irq_installed) {
+    irq_add_shared_handler(DMA_IRQ_0, ssd1306_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+    irq_installed = true;
+  }
+
+  // Primeiro painel do barramento: só o STOP_DET interessa, e só enquanto há troca pendente
+  ssd1306_bus_t *bus = ssd1306_bus(ssd);
+  if (!bus->i2c) {
+    uint irq = I2C0_IRQ + i2c_get_index(ssd->i2c_port);
+    bus->i2c = ssd->i2c_port;
+    i2c_get_hw(ssd->i2c_port)->intr_mask = 0;
+    irq_add_shared_handler(irq, ssd1306_i2c_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(irq, true);
+  }
+}
+
+// Converte uma janela em palavras para o DMA e retorna quantas foram escritas
+static size_t ssd1306_encode_window(ssd1306_t *ssd, const ssd1306_window_t *w, uint16_t *out) {
+  const uint8_t commands[6] = {SET_COL_ADDR, w->x0, w->x1, SET_PAGE_ADDR, w->p0, w->p1};
+  size_t len = 0;
+
+  // Uma transação com os seis comandos, igual a ssd1306_command_list, e outra com os dados
+  out[len++] = 0x00;
+  for (uint8_t i = 0; i < sizeof(commands); ++i)
+    out[len++] = commands[i];
+  out[len - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+  ssd->transactions += 2;
+
+  out[len++] = 0x40;
+  for (uint8_t x = w->x0; x <= w->x1; ++x) {
+    for (uint8_t page = w->p0; page <= w->p1; ++page) {
+      uint16_t index = ssd1306_index(ssd, x, page);
+      out[len++] = ssd->ram_buffer[index];
+      ssd->shadow_buffer[index] = ssd->ram_buffer[index];
+    }
+  }
+  out[len - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+  return len;
+}
+
+// Codifica as regiões alteradas no buffer de envio e retorna a quantidade de palavras.
+// O buffer é uma cópia: o desenho do próximo quadro já pode começar
+static size_t ssd1306_encode_dirty(ssd1306_t *ssd) {
+  if (ssd->busy)
+    return 0;
+
+  ssd1306_check_abort(ssd);
+
+  TIMING_BEGIN(start);
+  ssd1306_window_t windows[SSD1306_MAX_PAGES];
+  uint8_t count = ssd1306_plan_windows(ssd, windows);
+
+  size_t len = 0;
+  for (uint8_t i = 0; i < count; ++i)
+    len += ssd1306_encode_window(ssd, &windows[i], ssd->tx_buffer + len);
+
+  ssd->tx_len = len;
+  TIMING_END(etapa_codifica, start);
+  return len;
+}
+
+// Inicia o envio das regiões alteradas sem bloquear e retorna os bytes enfileirados.
+// Enquanto uma transferência está em andamento retorna 0 e as alterações ficam para o próximo envio.
+// Se outro painel do mesmo barramento estiver transmitindo, o quadro entra na fila atrás dele
+size_t ssd1306_send_dirty_async(ssd1306_t *ssd) {
+  if (ssd->dma_chan < 0)
+    return ssd1306_send_dirty(ssd);
+
+  size_t len = ssd1306_encode_dirty(ssd);
+  if (!len)
+    return 0;
+
+  ssd->busy = true;
+  uint32_t status = save_and_disable_interrupts();
+  ssd1306_bus_enqueue(ssd);
+  ssd1306_bus_kick(ssd1306_bus(ssd));
+  restore_interrupts(status);
+  return len;
+}
+
+// Envia vários painéis do mesmo barramento numa única sessão: todos os quadros são codificados
+// antes e entram juntos na fila, então as interrupções os transmitem um atrás do outro.
+// Retorna o total de bytes enfileirados
+size_t ssd1306_send_group_async(ssd1306_t *const *panels, uint8_t count) {
+  bool queued[SSD1306_BUS_MAX_PANELS] = {false};
+  size_t total = 0;
+
+  if (count > SSD1306_BUS_MAX_PANELS)
+    count = SSD1306_BUS_MAX_PANELS;
+
+  for (uint8_t i = 0; i < count; ++i) {
+    if (panels[i]->dma_chan < 0) {
+      total += ssd1306_send_dirty(panels[i]);
+    } else if (ssd1306_encode_dirty(panels[i])) {
+      total += panels[i]->tx_len;
+      panels[i]->busy = queued[i] = true;
+    }
+  }
+
+  uint32_t status = save_and_disable_interrupts();
+  for (uint8_t i = 0; i < count; ++i) {
+    if (queued[i])
+      ssd1306_bus_enqueue(panels[i]);
+  }
+  for (uint8_t i = 0; i < count; ++i) {
+    if (queued[i])
+      ssd1306_bus_kick(ssd1306_bus(panels[i]));
+  }
+  restore_interrupts(status);
+  return total;
+}
+
+bool ssd1306_send_busy(ssd1306_t *ssd) {
+  return ssd->busy;
+}
+
+// Aguarda o barramento do painel ficar livre: todos os quadros na fila entregues pelo DMA
+// e o controlador I2C com o FIFO vazio
+void ssd1306_send_wait(ssd1306_t *ssd) {
+  ssd1306_bus_t *bus = ssd1306_bus(ssd);
+  if (!bus->i2c)
+    return;
+
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  while (bus->active || bus->switching || bus->count || !ssd1306_bus_idle(hw))
+    tight_loop_contents();
+}
+
+// Estatísticas do barramento desde o início: sessões, quadros e trocas de endereço
+void ssd1306_get_bus_stats(i2c_inst_t *i2c, ssd1306_bus_stats_t *stats) {
+  *stats = buses[i2c_get_index(i2c)].stats;
+}
+
+void ssd1306_set_send_callback(ssd1306_t *ssd, ssd1306_send_callback_t callback, void *data) {
+  ssd->callback = callback;
+  ssd->callback_data = data;
 }
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
-  uint16_t index = (y >> 3) + (x << 3) + 1;
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+
+  uint16_t index = ssd1306_index(ssd, x, y >> 3);
   uint8_t pixel = (y & 0b111);
   if (value)
     ssd->ram_buffer[index] |= (1 << pixel);
   else
     ssd->ram_buffer[index] &= ~(1 << pixel);
+  ssd1306_mark_dirty(ssd, x, x, y >> 3);
 }
 
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
+// Substitui os bits indicados pela máscara em um byte do buffer
+static inline void ssd1306_write_bits(ssd1306_t *ssd, uint8_t x, uint8_t page, uint8_t mask, uint8_t bits) {
+  uint8_t *byte = &ssd->ram_buffer[ssd1306_index(ssd, x, page)];
+  *byte = (*byte & ~mask) | (bits & mask);
+}
+
+// Preenche a área x0..x1, y0..y1 (já recortada) escrevendo um byte mascarado por página
+static void ssd1306_fill_area(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y0, uint8_t y1, bool value) {
+  uint8_t p0 = y0 >> 3, p1 = y1 >> 3;
+  uint8_t first_mask = 0xFF << (y0 & 0b111);
+  uint8_t last_mask = 0xFF >> (7 - (y1 & 0b111));
+  uint8_t bits = value ? 0xFF : 0x00;
+
+  if (p0 == p1)
+    first_mask &= last_mask;
+
+  for (uint8_t x = x0; x <= x1; ++x) {
+    ssd1306_write_bits(ssd, x, p0, first_mask, bits);
+    if (p0 != p1) {
+      for (uint8_t page = p0 + 1; page < p1; ++page)
+        ssd->ram_buffer[ssd1306_index(ssd, x, page)] = bits;
+      ssd1306_write_bits(ssd, x, p1, last_mask, bits);
     }
+  }
+
+  for (uint8_t page = p0; page <= p1; ++page)
+    ssd1306_mark_dirty(ssd, x0, x1, page);
+}
+
+void ssd1306_fill(ssd1306_t *ssd, bool value) {
+  // O buffer inteiro (exceto o byte de controle 0x40) recebe o mesmo valor
+  memset(ssd->ram_buffer + 1, value ? 0xFF : 0x00, ssd->bufsize - 1);
+  ssd1306_mark_all_dirty(ssd);
 }
 
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
-  for (uint8_t x = left; x < left + width; ++x) {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
-  }
-  for (uint8_t y = top; y < top + height; ++y) {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
-  }
+  if (!width || !height || left >= ssd->width || top >= ssd->height)
+    return;
+
+  // Recorta uma única vez; as bordas fora da tela não são desenhadas
+  int right = left + width - 1;
+  int bottom = top + height - 1;
+  uint8_t x1 = right < ssd->width ? right : ssd->width - 1;
+  uint8_t y1 = bottom < ssd->height ? bottom : ssd->height - 1;
 
   if (fill) {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-        ssd1306_pixel(ssd, x, y, value);
-      }
-    }
+    ssd1306_fill_area(ssd, left, x1, top, y1, value);
+    return;
   }
+
+  ssd1306_fill_area(ssd, left, x1, top, top, value);
+  if (bottom == y1)
+    ssd1306_fill_area(ssd, left, x1, bottom, bottom, value);
+  ssd1306_fill_area(ssd, left, left, top, y1, value);
+  if (right == x1)
+    ssd1306_fill_area(ssd, right, right, top, y1, value);
 }
 
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
@@ -187,72 +655,55 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 }
 
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
+  if (x0 > x1 || x0 >= ssd->width || y >= ssd->height)
+    return;
+  if (x1 >= ssd->width)
+    x1 = ssd->width - 1;
+  ssd1306_fill_area(ssd, x0, x1, y, y, value);
 }
 
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  if (y0 > y1 || x >= ssd->width || y0 >= ssd->height)
+    return;
+  if (y1 >= ssd->height)
+    y1 = ssd->height - 1;
+  ssd1306_fill_area(ssd, x, x, y0, y1, value);
+}
+
+// Copia as colunas de um glifo 8x8 para a tela, sobrescrevendo os pixels da célula
+static void ssd1306_blit_glyph(ssd1306_t *ssd, const uint8_t *glyph, uint8_t x, uint8_t y) {
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+
+  uint8_t columns = ssd->width - x < 8 ? ssd->width - x : 8;
+  uint8_t page = y >> 3;
+  uint8_t shift = y & 0b111;
+  bool has_next = shift && page + 1 < ssd->pages;
+
+  for (uint8_t col = 0; col < columns; ++col) {
+    if (!shift) {
+      // Glifo alinhado à página: um byte inteiro por coluna
+      ssd->ram_buffer[ssd1306_index(ssd, x + col, page)] = glyph[col];
+    } else {
+      // Glifo desalinhado: a coluna é dividida entre duas páginas
+      ssd1306_write_bits(ssd, x + col, page, 0xFF << shift, glyph[col] << shift);
+      if (has_next)
+        ssd1306_write_bits(ssd, x + col, page + 1, 0xFF >> (8 - shift), glyph[col] >> (8 - shift));
+    }
+  }
+
+  ssd1306_mark_dirty(ssd, x, x + columns - 1, page);
+  if (has_next)
+    ssd1306_mark_dirty(ssd, x, x + columns - 1, page + 1);
 }
 
 // Função para desenhar um caractere
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y) {
-  uint16_t index = 0;
-  bool is_special = false;
-
-  if (c >= '0' && c <= '9') {
-      index = (c - '0' + 1) * 8;  // Números (0-9)
-  } 
-  else if (c >= 'A' && c <= 'Z') {
-      index = (c - 'A' + 11) * 8; // Letras maiúsculas (A-Z)
-  } 
-  else if (c >= 'a' && c <= 'z') {
-      index = (c - 'a' + 37) * 8; // Letras minúsculas (a-z)
-  } 
-  else if (c == ':') {
-      index = 63 * 8;  // Índice correto do ':'
-      is_special = true;
-  } 
-  else if (c == '/') {
-      index = 64 * 8;  // Índice correto do '/'
-  } 
-  else if (c == '(') {
-      index = 65 * 8;  // Índice correto do '('
-  }
-  else if (c == ')') {
-      index = 66 * 8;  // Índice correto do ')'
-  }
-  else {
-      return;  // Se o caractere não for suportado, não desenha nada
-  }
+  uint8_t glyph = font_glyph[(uint8_t)c];
+  if (!glyph)
+    return;  // Se o caractere não for suportado, não desenha nada
 
-  // 🔹 Para caracteres normais, mantém a exibição correta
-  if (!is_special) {
-      for (uint8_t col = 0; col < 8; ++col) {  
-          uint8_t line = font[index + col];  
-          for (uint8_t row = 0; row < 8; ++row) {  
-              if (line & (1 << row)) {  
-                  ssd1306_pixel(ssd, x + col, y + row, true);
-              } else {
-                  ssd1306_pixel(ssd, x + col, y + row, false);
-              }
-          }
-      }
-  } 
-  // 🔹 Para `:` apenas, usa a inversão para exibição correta
-  else {
-      for (uint8_t col = 0; col < 8; ++col) {  
-          uint8_t line = font[index + col];  
-          for (uint8_t row = 0; row < 8; ++row) {  
-              if (line & (1 << row)) {  
-                  ssd1306_pixel(ssd, x + row, y + col, true);  // 🔹 Corrigido apenas para `:`
-              } else {
-                  ssd1306_pixel(ssd, x + row, y + col, false);
-              }
-          }
-      }
-  }
+  ssd1306_blit_glyph(ssd, &font[glyph * 8], x, y);
 }
 
 // Função para desenhar uma string
@@ -274,6 +725,65 @@ void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
   }
 }
 
+// Rola o conteúdo das colunas x0..x1, páginas p0..p1, uma coluna para a esquerda no próprio
+// painel (rolagem de conteúdo, sem reenviar a região) e repete o deslocamento nos buffers.
+// A coluna x1 fica pendente de envio: desenhe a coluna nova e chame ssd1306_send_dirty
+void ssd1306_scroll_left(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1) {
+  if (x1 >= ssd->width || p1 >= ssd->pages || x0 >= x1 || p0 > p1)
+    return;
+
+  // Parâmetros: fixo, página inicial, fixo, página final, fixo, coluna inicial e final
+  const uint8_t commands[] = {SET_CONTENT_SCROLL_LEFT, 0x00, p0, 0x01, p1, 0x00, x0, x1};
+  ssd1306_command_list(ssd, commands, sizeof(commands));
+
+  for (uint8_t x = x0; x < x1; ++x) {
+    for (uint8_t page = p0; page <= p1; ++page) {
+      ssd->ram_buffer[ssd1306_index(ssd, x, page)] = ssd->ram_buffer[ssd1306_index(ssd, x + 1, page)];
+      ssd->shadow_buffer[ssd1306_index(ssd, x, page)] = ssd->shadow_buffer[ssd1306_index(ssd, x + 1, page)];
+    }
+  }
+
+  // O que o painel coloca na última coluna não é conhecido: força o reenvio
+  for (uint8_t page = p0; page <= p1; ++page) {
+    uint16_t index = ssd1306_index(ssd, x1, page);
+    ssd->shadow_buffer[index] = ~ssd->ram_buffer[index];
+    // Alterações ainda não enviadas foram deslocadas junto com o conteúdo
+    ssd1306_mark_dirty(ssd, x0, x1, page);
+  }
+}
+
+void ssd1306_text_field_init(ssd1306_text_field_t *field, uint8_t x, uint8_t y, uint8_t length) {
+  field->x = x;
+  field->y = y;
+  field->length = length > SSD1306_TEXT_FIELD_MAX ? SSD1306_TEXT_FIELD_MAX : length;
+  field->valid = false;
+}
+
+// Força o próximo ssd1306_text_field_draw a redesenhar todas as células (ex.: após limpar a tela)
+void ssd1306_text_field_invalidate(ssd1306_text_field_t *field) {
+  field->valid = false;
+}
+
+// Escreve o texto no campo redesenhando só as células cujo caractere mudou.
+// O restante do campo é apagado. Retorna o número de células redesenhadas
+uint8_t ssd1306_text_field_draw(ssd1306_t *ssd, ssd1306_text_field_t *field, const char *str) {
+  uint8_t drawn = 0;
+
+  for (uint8_t i = 0; i < field->length; ++i) {
+    char c = *str ? *str++ : ' ';
+    if (field->valid && field->shown[i] == c)
+      continue;
+
+    // Caracteres sem desenho ocupam a célula com o glifo vazio
+    field->shown[i] = c;
+    ssd1306_blit_glyph(ssd, &font[font_glyph[(uint8_t)c] * 8], field->x + i * 8, field->y);
+    drawn++;
+  }
+
+  field->valid = true;
+  return drawn;
+}
+
 void ssd1306_draw_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool color) {
   int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
   int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1; 
@@ -289,3 +799,108 @@ void ssd1306_draw_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8
       if (e2 <= dx) { err += dx; y0 += sy; }
   }
 }
+
+// Aplica o modo a um byte do buffer: bits são os pixels da imagem já deslocados para a página
+// e mask os pixels que ela cobre
+static inline void ssd1306_blit_byte(uint8_t *byte, uint8_t bits, uint8_t mask, ssd1306_blit_mode_t mode) {
+  switch (mode) {
+    case SSD1306_BLIT_COPY: *byte = (*byte & ~mask) | (bits & mask); break;
+    case SSD1306_BLIT_OR: *byte |= bits; break;
+    case SSD1306_BLIT_XOR: *byte ^= bits; break;
+    case SSD1306_BLIT_CLEAR: *byte &= ~bits; break;
+  }
+}
+
+// Modo que desfaz cada modo de desenho, supondo fundo apagado sob a imagem (exceto no XOR)
+static const ssd1306_blit_mode_t ssd1306_erase_mode[] = {
+  [SSD1306_BLIT_COPY] = SSD1306_BLIT_COPY,  // com a imagem zerada: apaga a área coberta
+  [SSD1306_BLIT_OR] = SSD1306_BLIT_CLEAR,
+  [SSD1306_BLIT_XOR] = SSD1306_BLIT_XOR,
+  [SSD1306_BLIT_CLEAR] = SSD1306_BLIT_OR,
+};
+
+static bool ssd1306_blit_image(ssd1306_t *ssd, const ssd1306_image_t *image, int16_t x, int16_t y,
+                               ssd1306_blit_mode_t mode, bool erase) {
+  int x0 = x < 0 ? 0 : x;
+  int x1 = x + image->width - 1;
+  if (x1 >= ssd->width)
+    x1 = ssd->width - 1;
+  if (!image->width || !image->height || x0 > x1 || y >= ssd->height || y + image->height <= 0)
+    return false;
+
+  // Deslocamento dentro da página e página da primeira faixa (pode ser negativa)
+  uint8_t shift = y & 0b111;
+  int base_page = (y - shift) / 8;
+  uint8_t bands = (image->height + 7) / 8;
+  uint8_t last_rows = 0xFF >> ((8 - image->height % 8) % 8);
+  bool clear = erase && mode == SSD1306_BLIT_COPY;
+  if (erase)
+    mode = ssd1306_erase_mode[mode];
+
+  for (uint8_t band = 0; band < bands; ++band) {
+    int page = base_page + band;
+    bool low = page >= 0 && page < ssd->pages;
+    bool high = shift && page + 1 >= 0 && page + 1 < ssd->pages;
+    if (!low && !high)
+      continue;
+
+    // Só as linhas que pertencem à imagem contam na última faixa
+    uint8_t rows = band == bands - 1 ? last_rows : 0xFF;
+    const uint8_t *data = image->data + band * image->width;
+    const uint8_t *mask = image->mask ? image->mask + band * image->width : NULL;
+
+    for (int col = x0; col <= x1; ++col) {
+      uint8_t bits = clear ? 0 : data[col - x] & rows;
+      uint8_t covered = mask ? mask[col - x] & rows : rows;
+      if (low)
+        ssd1306_blit_byte(&ssd->ram_buffer[ssd1306_index(ssd, col, page)], bits << shift, covered << shift, mode);
+      if (high)
+        ssd1306_blit_byte(&ssd->ram_buffer[ssd1306_index(ssd, col, page + 1)],
+                          bits >> (8 - shift), covered >> (8 - shift), mode);
+    }
+
+    if (low)
+      ssd1306_mark_dirty(ssd, x0, x1, page);
+    if (high)
+      ssd1306_mark_dirty(ssd, x0, x1, page + 1);
+  }
+
+  return true;
+}
+
+// Desenha a imagem com o canto superior esquerdo em (x, y), que podem estar fora da tela.
+// Desalinhada, cada faixa de 8 linhas da imagem se divide entre duas páginas. Só as colunas
+// alteradas entram nas regiões sujas. Retorna false se nada da imagem ficou na tela
+bool ssd1306_blit(ssd1306_t *ssd, const ssd1306_image_t *image, int16_t x, int16_t y, ssd1306_blit_mode_t mode) {
+  return ssd1306_blit_image(ssd, image, x, y, mode, false);
+}
+
+void ssd1306_sprite_init(ssd1306_sprite_t *sprite, const ssd1306_image_t *image, ssd1306_blit_mode_t mode) {
+  sprite->image = image;
+  sprite->mode = mode;
+  sprite->x = 0;
+  sprite->y = 0;
+  sprite->visible = false;
+}
+
+// Move o sprite (e o mostra, se estava escondido): a área antiga é apagada e a nova desenhada,
+// então o próximo envio leva só essas colunas. Parado no lugar, nada muda no buffer
+void ssd1306_sprite_move(ssd1306_t *ssd, ssd1306_sprite_t *sprite, int16_t x, int16_t y) {
+  if (sprite->visible) {
+    if (sprite->x == x && sprite->y == y)
+      return;
+    ssd1306_blit_image(ssd, sprite->image, sprite->x, sprite->y, sprite->mode, true);
+  }
+
+  ssd1306_blit_image(ssd, sprite->image, x, y, sprite->mode, false);
+  sprite->x = x;
+  sprite->y = y;
+  sprite->visible = true;
+}
+
+// Apaga o sprite da tela. Depois de limpar a tela por outro meio, basta marcar visible = false
+void ssd1306_sprite_hide(ssd1306_t *ssd, ssd1306_sprite_t *sprite) {
+  if (sprite->visible)
+    ssd1306_blit_image(ssd, sprite->image, sprite->x, sprite->y, sprite->mode, true);
+  sprite->visible = false;
+}
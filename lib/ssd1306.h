@@ -10,13 +10,21 @@ Este arquivo atua como um cabeçalho para o arquivo ssd1306.c, permitindo que ou
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
-#include "ws2812.pio.h"
 
-#define MATRIX_PIN 7
-#define NUM_LEDS 25
+// Número máximo de páginas (linhas de 8 pixels) suportado pelo controle de regiões sujas
+#define SSD1306_MAX_PAGES 8
 
-#define WIDTH 128
-#define HEIGHT 64
+// Número máximo de painéis com envio assíncrono no mesmo barramento I2C
+#define SSD1306_BUS_MAX_PANELS 4
+
+// Comandos enviados numa única transação por ssd1306_command_list (listas maiores são divididas)
+#define SSD1306_COMMAND_LIST_MAX 32
+
+// Número máximo de caracteres de um campo de texto
+#define SSD1306_TEXT_FIELD_MAX 16
+
+// Chamada (em contexto de interrupção) quando o DMA termina de entregar um quadro ao I2C
+typedef void (*ssd1306_send_callback_t)(void *data);
 
 typedef struct {
   uint8_t width, height, pages, address;
@@ -24,17 +32,68 @@ typedef struct {
   bool external_vcc;
   uint8_t *ram_buffer;
   size_t bufsize;
-  uint8_t port_buffer[2];
+  // Byte de controle 0x00 seguido da lista de comandos da transação
+  uint8_t command_buffer[SSD1306_COMMAND_LIST_MAX + 1];
+  uint32_t transactions;  // transações I2C iniciadas pelo driver (comandos e dados)
+  // Controle de regiões sujas: cada página guarda o intervalo de colunas alterado
+  uint8_t dirty_pages;
+  uint8_t dirty_x0[SSD1306_MAX_PAGES];
+  uint8_t dirty_x1[SSD1306_MAX_PAGES];
+  // Cópia do conteúdo atual do painel e buffer auxiliar para envio de janelas
+  uint8_t *shadow_buffer;
+  uint8_t *window_buffer;
+  bool shadow_valid;
+  // Envio assíncrono: palavras prontas para o FIFO do I2C, transferidas por DMA
+  uint16_t *tx_buffer;
+  size_t tx_len;
+  int dma_chan;
+  volatile bool busy;
+  ssd1306_send_callback_t callback;
+  void *callback_data;
 } ssd1306_t;
 
-extern ssd1306_t ssd;
-extern PIO pio;
-extern uint sm;
-extern uint offset;
-extern uint32_t RED;
-extern uint32_t GREEN;
-extern uint32_t BLUE;
-extern uint32_t WHITE;
+// Contadores de um barramento compartilhado. Cada sessão começa com o barramento parado e
+// termina quando a fila esvazia; frames / sessions mostra quantos quadros saíram em sequência
+typedef struct {
+  uint32_t sessions;
+  uint32_t frames;
+  uint32_t switches;  // trocas do endereço de destino entre painéis
+} ssd1306_bus_stats_t;
+
+// Campo de texto de uma linha que lembra o que está exibindo em cada célula de 8x8
+typedef struct {
+  uint8_t x, y, length;
+  bool valid;
+  char shown[SSD1306_TEXT_FIELD_MAX];
+} ssd1306_text_field_t;
+
+// Imagem para blit no mesmo formato do buffer: cada byte é uma coluna de 8 pixels (bit 0 em
+// cima) e as faixas de 8 linhas vêm em sequência, data[faixa * width + coluna]. A máscara
+// opcional, no mesmo formato, diz quais pixels a imagem cobre no modo SSD1306_BLIT_COPY
+typedef struct {
+  uint8_t width, height;
+  const uint8_t *data;
+  const uint8_t *mask;
+} ssd1306_image_t;
+
+// Declara uma imagem de um atlas constante (a máscara pode ser NULL)
+#define SSD1306_IMAGE(w, h, bits, mask_bits) {(w), (h), (bits), (mask_bits)}
+
+// Como a imagem se combina com o que já está no buffer
+typedef enum {
+  SSD1306_BLIT_COPY,   // substitui os pixels cobertos (a máscara, ou o retângulo inteiro)
+  SSD1306_BLIT_OR,     // acende os pixels da imagem
+  SSD1306_BLIT_XOR,    // inverte; repetir o blit no mesmo lugar restaura o fundo
+  SSD1306_BLIT_CLEAR,  // apaga os pixels da imagem
+} ssd1306_blit_mode_t;
+
+// Objeto móvel: mover apaga só a área ocupada antes e desenha na nova posição
+typedef struct {
+  const ssd1306_image_t *image;
+  ssd1306_blit_mode_t mode;
+  int16_t x, y;
+  bool visible;
+} ssd1306_sprite_t;
 
 typedef enum {
   SET_CONTRAST = 0x81,
@@ -53,13 +112,54 @@ typedef enum {
   SET_DISP_CLK_DIV = 0xD5,
   SET_PRECHARGE = 0xD9,
   SET_VCOM_DESEL = 0xDB,
-  SET_CHARGE_PUMP = 0x8D
+  SET_CHARGE_PUMP = 0x8D,
+  SET_HSCROLL_RIGHT = 0x26,
+  SET_HSCROLL_LEFT = 0x27,
+  SET_CONTENT_SCROLL_RIGHT = 0x2C,
+  SET_CONTENT_SCROLL_LEFT = 0x2D,
+  SET_SCROLL_OFF = 0x2E,
+  SET_SCROLL_ON = 0x2F
 } ssd1306_command_t;
 
+// Sequência de inicialização para um painel de height linhas, montada pelo compilador:
+// static const uint8_t init[] = SSD1306_INIT_SEQUENCE(64, false);
+// Painéis de 64 linhas usam os pinos COM alternados e os de 32 (ou menos), sequenciais; com
+// VCC externo a bomba de carga fica desligada e a pré-carga é mais curta
+#define SSD1306_INIT_SEQUENCE(height, external_vcc) {           \
+  SET_DISP | 0x00,                                             \
+  SET_MEM_ADDR, 0x01,                                          \
+  SET_DISP_START_LINE | 0x00,                                  \
+  SET_SEG_REMAP | 0x01,                                        \
+  SET_MUX_RATIO, (height) - 1,                                 \
+  SET_COM_OUT_DIR | 0x08,                                      \
+  SET_DISP_OFFSET, 0x00,                                       \
+  SET_COM_PIN_CFG, (height) > 32 ? 0x12 : 0x02,                \
+  SET_DISP_CLK_DIV, 0x80,                                      \
+  SET_PRECHARGE, (external_vcc) ? 0x22 : 0xF1,                 \
+  SET_VCOM_DESEL, 0x30,                                        \
+  SET_CONTRAST, 0xFF,                                          \
+  SET_ENTIRE_ON,                                               \
+  SET_NORM_INV,                                                \
+  SET_CHARGE_PUMP, (external_vcc) ? 0x10 : 0x14,               \
+  SET_DISP | 0x01,                                             \
+}
+
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
-void ssd1306_send_data(ssd1306_t *ssd);
+void ssd1306_command_list(ssd1306_t *ssd, const uint8_t *commands, size_t count);
+void ssd1306_set_contrast(ssd1306_t *ssd, uint8_t contrast);
+void ssd1306_set_power(ssd1306_t *ssd, bool on);
+size_t ssd1306_send_data(ssd1306_t *ssd);
+size_t ssd1306_send_dirty(ssd1306_t *ssd);
+void ssd1306_invalidate(ssd1306_t *ssd);
+void ssd1306_async_init(ssd1306_t *ssd);
+size_t ssd1306_send_dirty_async(ssd1306_t *ssd);
+size_t ssd1306_send_group_async(ssd1306_t *const *panels, uint8_t count);
+bool ssd1306_send_busy(ssd1306_t *ssd);
+void ssd1306_send_wait(ssd1306_t *ssd);
+void ssd1306_set_send_callback(ssd1306_t *ssd, ssd1306_send_callback_t callback, void *data);
+void ssd1306_get_bus_stats(i2c_inst_t *i2c, ssd1306_bus_stats_t *stats);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
@@ -69,9 +169,14 @@ void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+void ssd1306_scroll_left(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1);
+void ssd1306_text_field_init(ssd1306_text_field_t *field, uint8_t x, uint8_t y, uint8_t length);
+void ssd1306_text_field_invalidate(ssd1306_text_field_t *field);
+uint8_t ssd1306_text_field_draw(ssd1306_t *ssd, ssd1306_text_field_t *field, const char *str);
 void ssd1306_draw_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool color);
-void set_matrix_color(uint32_t color);
-void init_matrix();
-void ws2812_put_pixel(uint32_t pixel_grb);
+bool ssd1306_blit(ssd1306_t *ssd, const ssd1306_image_t *image, int16_t x, int16_t y, ssd1306_blit_mode_t mode);
+void ssd1306_sprite_init(ssd1306_sprite_t *sprite, const ssd1306_image_t *image, ssd1306_blit_mode_t mode);
+void ssd1306_sprite_move(ssd1306_t *ssd, ssd1306_sprite_t *sprite, int16_t x, int16_t y);
+void ssd1306_sprite_hide(ssd1306_t *ssd, ssd1306_sprite_t *sprite);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,182 @@
+/*
+O arquivo telemetry.c implementa o fluxo de telemetria.
+telemetry_record (produtor, pode rodar em interrupção) monta o pacote atual e, quando ele
+fecha, codifica e copia para o buffer circular. telemetry_poll (consumidor, no laço principal)
+entrega ao transporte o que couber. Cada lado só escreve o próprio índice do buffer.
+*/
+
+#include <string.h>
+#include "telemetry.h"
+#include "hardware/sync.h"
+
+static telemetry_write_t writer;
+static telemetry_stats_t stats;
+
+// Pacote em montagem (somente o produtor acessa)
+static uint8_t packet[TELEMETRY_MAX_PAYLOAD];
+static uint8_t message[TELEMETRY_MAX_FRAME];
+static uint8_t encoded[TELEMETRY_MAX_ENCODED];
+static uint8_t record_count;
+static uint16_t sequence;
+static uint32_t base_time;
+
+static uint8_t ring[TELEMETRY_RING_SIZE];
+static volatile uint32_t ring_head;  // escrito só pelo produtor
+static volatile uint32_t ring_tail;  // escrito só pelo consumidor
+
+static inline void put16(uint8_t *p, uint16_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+}
+
+static inline void put32(uint8_t *p, uint32_t v) {
+  put16(p, v);
+  put16(p + 2, v >> 16);
+}
+
+// CRC-16/CCITT-FALSE (polinômio 0x1021, valor inicial 0xFFFF)
+uint16_t telemetry_crc16(const uint8_t *data, size_t len) {
+  uint16_t crc = 0xFFFF;
+  while (len--) {
+    crc ^= (uint16_t)*data++ << 8;
+    for (uint8_t bit = 0; bit < 8; ++bit)
+      crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+// Codifica em COBS e acrescenta o delimitador 0x00; retorna o tamanho escrito
+size_t telemetry_cobs_encode(const uint8_t *in, size_t len, uint8_t *out) {
+  size_t code_pos = 0, pos = 1;
+  uint8_t code = 1;
+
+  for (size_t i = 0; i < len; ++i) {
+    if (in[i]) {
+      out[pos++] = in[i];
+      code++;
+    }
+    if (!in[i] || code == 0xFF) {
+      out[code_pos] = code;
+      code_pos = pos++;
+      code = 1;
+    }
+  }
+  out[code_pos] = code;
+  out[pos++] = 0x00;
+  return pos;
+}
+
+// Monta e codifica uma mensagem avulsa em out (TELEMETRY_MAX_ENCODED bytes) sem passar pelo
+// buffer circular; retorna o tamanho codificado, ou 0 se os dados não cabem numa mensagem
+size_t telemetry_encode_message(uint8_t type, const uint8_t *data, size_t len, uint8_t *out) {
+  if (len > TELEMETRY_MESSAGE_MAX_DATA)
+    return 0;
+
+  uint8_t frame[TELEMETRY_MAX_FRAME];
+  frame[0] = type;
+  memcpy(frame + 1, data, len);
+  put16(frame + 1 + len, telemetry_crc16(frame, 1 + len));
+  return telemetry_cobs_encode(frame, 1 + len + TELEMETRY_CRC_SIZE, out);
+}
+
+void telemetry_init(telemetry_write_t write) {
+  writer = write;
+  memset(&stats, 0, sizeof(stats));
+  record_count = 0;
+  sequence = 0;
+  ring_head = ring_tail = 0;
+}
+
+// Acrescenta o CRC, codifica e copia o quadro para o buffer circular se houver espaço
+static bool enqueue_frame(uint8_t *frame, size_t len) {
+  put16(frame + len, telemetry_crc16(frame, len));
+  len += TELEMETRY_CRC_SIZE;
+
+  size_t n = telemetry_cobs_encode(frame, len, encoded);
+  uint32_t head = ring_head;
+  if (TELEMETRY_RING_SIZE - (head - ring_tail) < n)
+    return false;
+
+  for (size_t i = 0; i < n; ++i)
+    ring[(head + i) % TELEMETRY_RING_SIZE] = encoded[i];
+  __dmb();
+  ring_head = head + n;
+  return true;
+}
+
+// Fecha o pacote atual
+static void close_packet(void) {
+  size_t len = TELEMETRY_HEADER_SIZE + record_count * TELEMETRY_RECORD_SIZE;
+  packet[0] = TELEMETRY_VERSION;
+  put16(packet + 1, sequence++);
+  packet[3] = record_count;
+  put32(packet + 4, base_time);
+  record_count = 0;
+
+  // A sequência avança mesmo se o pacote for descartado: o decodificador enxerga a perda
+  if (enqueue_frame(packet, len))
+    stats.packets++;
+  else
+    stats.dropped++;
+}
+
+// Acrescenta um registro ao pacote atual
+void telemetry_record(uint32_t time_us, const uint16_t *channels, uint8_t state) {
+  // O delta de tempo tem 16 bits: um intervalo maior fecha o pacote
+  if (record_count && time_us - base_time > 0xFFFF)
+    close_packet();
+  if (!record_count)
+    base_time = time_us;
+
+  uint8_t *p = packet + TELEMETRY_HEADER_SIZE + record_count * TELEMETRY_RECORD_SIZE;
+  put16(p, time_us - base_time);
+  for (uint8_t c = 0; c < TELEMETRY_CHANNELS; ++c)
+    put16(p + 2 + 2 * c, channels[c]);
+  p[2 + 2 * TELEMETRY_CHANNELS] = state;
+
+  stats.records++;
+  if (++record_count == TELEMETRY_RECORDS_PER_PACKET)
+    close_packet();
+}
+
+// Enfileira uma mensagem avulsa entre os pacotes de leituras; retorna false se não couber.
+// As interrupções ficam desligadas durante a cópia porque o produtor dos pacotes roda em interrupção
+bool telemetry_send(uint8_t type, const uint8_t *data, size_t len) {
+  if (len > TELEMETRY_MESSAGE_MAX_DATA)
+    return false;
+
+  uint32_t status = save_and_disable_interrupts();
+  message[0] = type;
+  memcpy(message + 1, data, len);
+  bool sent = enqueue_frame(message, 1 + len);
+  restore_interrupts(status);
+  return sent;
+}
+
+// Entrega ao transporte os bytes prontos, sem esperar por espaço
+void telemetry_poll(void) {
+  if (!writer)
+    return;
+
+  uint32_t head = ring_head;
+  __dmb();
+  while (ring_tail != head) {
+    uint32_t tail = ring_tail;
+    uint32_t offset = tail % TELEMETRY_RING_SIZE;
+    uint32_t len = head - tail;
+    // Trecho contíguo até o fim do buffer
+    if (len > TELEMETRY_RING_SIZE - offset)
+      len = TELEMETRY_RING_SIZE - offset;
+
+    uint32_t written = writer(ring + offset, len);
+    stats.bytes += written;
+    __dmb();
+    ring_tail = tail + written;
+    if (written < len)
+      break;
+  }
+}
+
+const telemetry_stats_t *telemetry_stats(void) {
+  return &stats;
+}
@@ -0,0 +1,62 @@
+/*
+O arquivo telemetry.h declara o fluxo de telemetria binária.
+Leituras brutas com marca de tempo e estado são agrupadas em pacotes com número de sequência
+e CRC-16, codificados em COBS (o byte 0x00 separa os pacotes) e guardados num buffer circular.
+O envio drena o buffer sem bloquear; se o buffer enche, o pacote é descartado e contado.
+
+Formato do pacote antes da codificação (little-endian):
+  versão (1) | sequência (2) | registros (1) | tempo base em us (4)
+  registros: delta de tempo em us (2) | canais (2 cada) | estado (1)
+  CRC-16/CCITT-FALSE de todos os bytes anteriores (2)
+
+Mensagens avulsas (telemetry_send) usam o mesmo enquadramento: tipo (1) | dados | CRC-16 (2).
+O tipo distingue as mensagens dos pacotes de leituras, cujo primeiro byte é a versão.
+telemetry_encode_message monta o mesmo quadro sem o buffer circular, para quem escreve direto
+no transporte (o despejo do log quando a telemetria está desligada).
+*/
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "pico/stdlib.h"
+
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_CHANNELS 2
+#define TELEMETRY_RECORDS_PER_PACKET 32
+
+// Tamanho do buffer circular de saída (potência de 2)
+#define TELEMETRY_RING_SIZE 2048
+
+#define TELEMETRY_HEADER_SIZE 8
+#define TELEMETRY_RECORD_SIZE (2 + 2 * TELEMETRY_CHANNELS + 1)
+#define TELEMETRY_CRC_SIZE 2
+#define TELEMETRY_MAX_PAYLOAD (TELEMETRY_HEADER_SIZE + TELEMETRY_RECORDS_PER_PACKET * TELEMETRY_RECORD_SIZE + TELEMETRY_CRC_SIZE)
+
+// Mensagens avulsas: tipo e tamanho máximo dos dados (uma página do log na flash)
+#define TELEMETRY_MESSAGE_LOG_PAGE 0x81
+#define TELEMETRY_MESSAGE_MAX_DATA 256
+#define TELEMETRY_MAX_FRAME (1 + TELEMETRY_MESSAGE_MAX_DATA + TELEMETRY_CRC_SIZE)
+// Maior quadro depois do COBS, com o delimitador
+#define TELEMETRY_MAX_ENCODED (TELEMETRY_MAX_FRAME + TELEMETRY_MAX_FRAME / 254 + 2)
+
+// Escreve até len bytes no transporte e retorna quantos foram aceitos (nunca bloqueia)
+typedef uint32_t (*telemetry_write_t)(const uint8_t *data, uint32_t len);
+
+typedef struct {
+  uint32_t records;
+  uint32_t packets;
+  uint32_t dropped;  // pacotes descartados por falta de espaço no buffer
+  uint32_t bytes;    // bytes entregues ao transporte
+} telemetry_stats_t;
+
+void telemetry_init(telemetry_write_t write);
+void telemetry_record(uint32_t time_us, const uint16_t *channels, uint8_t state);
+bool telemetry_send(uint8_t type, const uint8_t *data, size_t len);
+void telemetry_poll(void);
+const telemetry_stats_t *telemetry_stats(void);
+
+uint16_t telemetry_crc16(const uint8_t *data, size_t len);
+size_t telemetry_cobs_encode(const uint8_t *in, size_t len, uint8_t *out);
+size_t telemetry_encode_message(uint8_t type, const uint8_t *data, size_t len, uint8_t *out);
+
+#endif
@@ -0,0 +1,80 @@
+/*
+O arquivo timing.c implementa a medição de tempo das etapas.
+Registrar uma duração custa algumas somas e comparações, sem laços nem divisões; a listagem das
+etapas e as médias só são calculadas no despejo, fora do caminho medido.
+*/
+
+#include <stdio.h>
+#include "timing.h"
+
+#if TIMING
+
+// Uma lista por núcleo: cada etapa é medida sempre no mesmo núcleo, então a inserção não
+// disputa a lista com o outro
+static timing_stage_t *stages[2];
+
+// Faixa do histograma: número de bits significativos da duração, limitado à última faixa
+static inline uint timing_bucket(uint32_t us) {
+  uint bucket = us ? 32 - __builtin_clz(us) : 0;
+  return bucket < TIMING_BUCKETS ? bucket : TIMING_BUCKETS - 1;
+}
+
+void timing_record(timing_stage_t *stage, uint32_t us) {
+  if (!stage->listed) {
+    stage->listed = true;
+    uint core = get_core_num();
+    stage->next = stages[core];
+    stages[core] = stage;
+  }
+
+  stage->count++;
+  stage->total_us += us;
+  if (us < stage->min_us)
+    stage->min_us = us;
+  if (us > stage->max_us)
+    stage->max_us = us;
+  stage->buckets[timing_bucket(us)]++;
+}
+
+static void timing_print(const timing_stage_t *stage) {
+  printf("  %-16s %7lu %7lu %7lu %7lu |", stage->name, (unsigned long)stage->count,
+         (unsigned long)stage->min_us, (unsigned long)(stage->total_us / stage->count),
+         (unsigned long)stage->max_us);
+  for (uint bucket = 0; bucket < TIMING_BUCKETS; ++bucket) {
+    if (!stage->buckets[bucket])
+      continue;
+    if (bucket == TIMING_BUCKETS - 1)
+      printf(" >=%lu:%lu", 1ul << (bucket - 1), (unsigned long)stage->buckets[bucket]);
+    else
+      printf(" <%lu:%lu", 1ul << bucket, (unsigned long)stage->buckets[bucket]);
+  }
+  printf("\n");
+}
+
+// Imprime cada etapa medida: contagem, mínimo, média e máximo, e as faixas não vazias do
+// histograma como "<limite us:contagem"
+void timing_dump(void) {
+  printf("Tempos (us): etapa, execuções, mín, média, máx | histograma\n");
+  for (uint core = 0; core < 2; ++core) {
+    for (timing_stage_t *stage = stages[core]; stage; stage = stage->next) {
+      if (stage->count)
+        timing_print(stage);
+    }
+  }
+}
+
+// Zera as medições; as etapas continuam nas listas
+void timing_reset(void) {
+  for (uint core = 0; core < 2; ++core) {
+    for (timing_stage_t *stage = stages[core]; stage; stage = stage->next) {
+      stage->count = 0;
+      stage->total_us = 0;
+      stage->min_us = UINT32_MAX;
+      stage->max_us = 0;
+      for (uint bucket = 0; bucket < TIMING_BUCKETS; ++bucket)
+        stage->buckets[bucket] = 0;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,57 @@
+/*
+O arquivo timing.h declara a medição de tempo das etapas do firmware.
+Cada etapa acumula contagem, mínimo, máximo, soma e um histograma em potências de 2 de
+microssegundos. Com TIMING=0 (padrão) as macros não geram código algum, como o DEBUG_PRINT;
+compile com TIMING=1 em todos os arquivos (add_compile_definitions) para ligar a medição.
+*/
+
+#ifndef TIMING_H
+#define TIMING_H
+
+#include "pico/stdlib.h"
+
+#ifndef TIMING
+#define TIMING 0
+#endif
+
+// Faixas do histograma: a faixa k conta durações de 2^(k-1) até 2^k - 1 us (a 0 conta 0 us);
+// a última acumula tudo acima de 2^(TIMING_BUCKETS-2) us
+#define TIMING_BUCKETS 20
+
+typedef struct timing_stage {
+  const char *name;
+  struct timing_stage *next;  // lista das etapas já medidas, montada na primeira medição
+  bool listed;
+  uint32_t count;
+  uint32_t min_us, max_us;
+  uint64_t total_us;
+  uint32_t buckets[TIMING_BUCKETS];
+} timing_stage_t;
+
+#if TIMING
+
+// Declara uma etapa (no escopo do arquivo): TIMING_STAGE(etapa_envio, "envio");
+#define TIMING_STAGE(var, label) static timing_stage_t var = {.name = label, .min_us = UINT32_MAX}
+// Marca o início em uma variável local e registra a duração até o fim
+#define TIMING_BEGIN(start) uint32_t start = time_us_32()
+#define TIMING_END(var, start) timing_record(&(var), time_us_32() - (start))
+// Registra uma duração já calculada (por exemplo, entre uma interrupção e outra)
+#define TIMING_RECORD(var, us) timing_record(&(var), (us))
+
+void timing_record(timing_stage_t *stage, uint32_t us);
+void timing_dump(void);
+void timing_reset(void);
+
+#else
+
+#define TIMING_STAGE(var, label) struct timing_unused_##var
+#define TIMING_BEGIN(start)
+#define TIMING_END(var, start)
+#define TIMING_RECORD(var, us)
+
+static inline void timing_dump(void) {}
+static inline void timing_reset(void) {}
+
+#endif
+
+#endif
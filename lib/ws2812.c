@@ -0,0 +1,110 @@
+/*
+O arquivo ws2812.c implementa o controle de matrizes de LEDs WS2812.
+O programa do PIO gera a forma de onda e o quadro inteiro é entregue ao FIFO da máquina de estados
+por DMA; só há envio quando alguma cor mudou desde o último quadro.
+*/
+
+#include <stdlib.h>
+#include "ws2812.h"
+#include "ws2812.pio.h"
+#include "timing.h"
+#include "hardware/dma.h"
+
+// Conversão do quadro em palavras do PIO (com TIMING=1)
+TIMING_STAGE(etapa_quadro, "ws2812 quadro");
+
+// Inicializa uma matriz width x height ligada ao pino informado, com o brilho no máximo
+void ws2812_init(ws2812_t *leds, PIO pio, uint pin, uint8_t width, uint8_t height) {
+  leds->pio = pio;
+  leds->offset = pio_add_program(pio, &ws2812_program);
+  leds->sm = pio_claim_unused_sm(pio, true);
+  ws2812_program_init(pio, leds->sm, leds->offset, pin, 800000, false);
+
+  leds->width = width;
+  leds->height = height;
+  leds->count = width * height;
+  leds->frame = calloc(leds->count, sizeof(uint32_t));
+  leds->words = calloc(leds->count, sizeof(uint32_t));
+
+  // O quadro é entregue ao FIFO do PIO por DMA, no ritmo do DREQ da máquina de estados
+  leds->dma_chan = dma_claim_unused_channel(true);
+  dma_channel_config c = dma_channel_get_default_config(leds->dma_chan);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+  channel_config_set_read_increment(&c, true);
+  channel_config_set_write_increment(&c, false);
+  channel_config_set_dreq(&c, pio_get_dreq(pio, leds->sm, true));
+  dma_channel_configure(leds->dma_chan, &c, &pio->txf[leds->sm], leds->words, leds->count, false);
+
+  ws2812_set_brightness(leds, 255);
+}
+
+// Monta a tabela de correção: gama 2 seguida do brilho (0 a 255), tudo em inteiros
+void ws2812_set_brightness(ws2812_t *leds, uint8_t brightness) {
+  for (uint32_t i = 0; i < 256; i++)
+    leds->lut[i] = (i * i * brightness + 255 * 255 / 2) / (255 * 255);
+  leds->dirty = true;
+}
+
+// Índice do LED na cadeia: a matriz é percorrida em serpentina a partir do canto inferior direito
+static inline uint ws2812_index(const ws2812_t *leds, uint8_t x, uint8_t y) {
+  if (y % 2 == 0)
+    return leds->count - 1 - (y * leds->width + x);
+  return leds->count - 1 - (y * leds->width + (leds->width - 1 - x));
+}
+
+// Define a cor (GRB) de um LED; (0, 0) é o canto superior esquerdo
+void ws2812_set_pixel(ws2812_t *leds, uint8_t x, uint8_t y, uint32_t color) {
+  if (x >= leds->width || y >= leds->height)
+    return;
+  uint i = ws2812_index(leds, x, y);
+  if (leds->frame[i] != color) {
+    leds->frame[i] = color;
+    leds->dirty = true;
+  }
+}
+
+void ws2812_fill(ws2812_t *leds, uint32_t color) {
+  for (uint i = 0; i < leds->count; i++) {
+    if (leds->frame[i] != color) {
+      leds->frame[i] = color;
+      leds->dirty = true;
+    }
+  }
+}
+
+// Envia o quadro por DMA se algo mudou desde o último envio. Retorna true se enviou
+bool ws2812_show(ws2812_t *leds) {
+  if (!leds->dirty || leds->dma_chan < 0)
+    return false;
+
+  // As palavras só podem ser reescritas depois que o DMA anterior terminou de lê-las
+  dma_channel_wait_for_finish_blocking(leds->dma_chan);
+
+  TIMING_BEGIN(start);
+  for (uint i = 0; i < leds->count; i++) {
+    uint32_t color = leds->frame[i];
+    uint32_t g = leds->lut[(color >> 16) & 0xFF];
+    uint32_t r = leds->lut[(color >> 8) & 0xFF];
+    uint32_t b = leds->lut[color & 0xFF];
+    leds->words[i] = ((g << 16) | (r << 8) | b) << 8u;
+  }
+  leds->dirty = false;
+  TIMING_END(etapa_quadro, start);
+
+  dma_channel_set_read_addr(leds->dma_chan, leds->words, true);
+  return true;
+}
+
+// Define a cor da matriz inteira; nada é enviado se a cor não mudou
+void ws2812_set_color(ws2812_t *leds, uint32_t color) {
+  ws2812_fill(leds, color);
+  ws2812_show(leds);
+}
+
+// Escreve um pixel direto no FIFO, sem passar pelo quadro (sem correção de brilho)
+void ws2812_put_pixel(ws2812_t *leds, uint32_t pixel_grb) {
+  // Aguarda o FIFO estar disponível
+  while (pio_sm_is_tx_fifo_full(leds->pio, leds->sm));
+  // Envia os bits do pixel no formato GRB
+  pio_sm_put_blocking(leds->pio, leds->sm, pixel_grb << 8u);
+}
@@ -0,0 +1,42 @@
+/*
+O arquivo ws2812.h declara o controle de matrizes de LEDs WS2812 ligadas a uma máquina de estados do PIO.
+Cada matriz é uma instância de ws2812_t com o próprio quadro, tabela de brilho e canal de DMA,
+então mais de uma cadeia de LEDs pode ser usada ao mesmo tempo.
+*/
+
+#ifndef WS2812_H
+#define WS2812_H
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+// Cores no formato GRB usado pelos LEDs
+#define WS2812_RED    0x00FF00
+#define WS2812_GREEN  0xFF0000
+#define WS2812_BLUE   0x0000FF
+#define WS2812_YELLOW 0xFFFF00
+#define WS2812_CYAN   0xFF00FF
+#define WS2812_WHITE  0xFFFFFF
+
+typedef struct {
+  PIO pio;
+  uint sm, offset;
+  int dma_chan;
+  uint8_t width, height;
+  uint16_t count;
+  // Quadro: cores pedidas (GRB) e palavras prontas para o FIFO do PIO
+  uint32_t *frame;
+  uint32_t *words;
+  uint8_t lut[256];
+  bool dirty;
+} ws2812_t;
+
+void ws2812_init(ws2812_t *leds, PIO pio, uint pin, uint8_t width, uint8_t height);
+void ws2812_set_brightness(ws2812_t *leds, uint8_t brightness);
+void ws2812_set_pixel(ws2812_t *leds, uint8_t x, uint8_t y, uint32_t color);
+void ws2812_fill(ws2812_t *leds, uint32_t color);
+bool ws2812_show(ws2812_t *leds);
+void ws2812_set_color(ws2812_t *leds, uint32_t color);
+void ws2812_put_pixel(ws2812_t *leds, uint32_t pixel_grb);
+
+#endif
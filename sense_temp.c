@@ -1,21 +1,69 @@
 #include <stdio.h>
+#include <string.h>
 #include "pico/stdlib.h"
+#include "sense_temp.h"
 #include "lib/ssd1306.h"
-#include "hardware/adc.h"
-#include "lib/ws2812.pio.h"
+#include "lib/sprites.h"
+#include "lib/adc_acq.h"
+#include "lib/buzzer.h"
+#include "lib/scheduler.h"
+#include "lib/snapshot.h"
+#include "lib/history.h"
+#include "lib/calib.h"
+#include "lib/sensor.h"
+#include "lib/alarm.h"
+#include "lib/flash_log.h"
+#include "lib/input.h"
+#include "lib/refresh.h"
+#include "lib/dsp.h"
+#include "lib/timing.h"
+#include "lib/ws2812.h"
 #include "hardware/pwm.h"
 
+// Com TELEMETRIA as leituras brutas saem em pacotes binários pela USB, decodificados no
+// computador por host/tools/telemetry_decode; o texto de depuração corromperia o fluxo
+#ifndef TELEMETRIA
+#define TELEMETRIA 0
+#endif
+
 // Habilita ou desabilita o modo de depuração
-#define DEBUG 1
+#ifndef DEBUG
+#define DEBUG (!TELEMETRIA)
+#endif
+
+#if DEBUG && TELEMETRIA
+#error "DEBUG e TELEMETRIA usam a mesma porta USB"
+#endif
 
+// Com DUAL_CORE o núcleo 1 desenha e envia o display e a matriz WS2812, e o núcleo 0
+// fica com a aquisição, o alarme e os botões; um quadro lento no I2C não atrasa a amostragem
+#ifndef DUAL_CORE
+#define DUAL_CORE 1
+#endif
+
+#if DUAL_CORE
+#include "pico/multicore.h"
+#endif
+
+// Com BAIXO_CONSUMO o firmware já inicia no modo de baixo consumo (alternado pelo comando 'e'):
+// o ADC fica parado entre as amostras e o display escurece e apaga quando os botões não são usados
+#ifndef BAIXO_CONSUMO
+#define BAIXO_CONSUMO 0
+#endif
+
+// O quadro da telemetria também leva as páginas do despejo do log sem TELEMETRIA
+#include "lib/telemetry.h"
+#include "pico/stdio_usb.h"
+#include "tusb.h"
+
+// Durante o despejo do log o texto de depuração fica suspenso para não entrar no meio dos quadros
 #if DEBUG
-    #define DEBUG_PRINT(...) printf(__VA_ARGS__)
+    #define DEBUG_PRINT(...) do { if (despejo_pagina < 0) printf(__VA_ARGS__); } while (0)
 #else
     #define DEBUG_PRINT(...)
 #endif
 
-// Configuração dos pinos do biossensor e botões
-#define SENSE 26 
+// Configuração dos pinos do joystick e botões (as entradas do ADC estão na tabela de canais)
 #define JOYSTICK_X_PIN 27
 #define JOYSTICK_Y_PIN 26
        
@@ -31,25 +79,301 @@
 #define I2C_SDA 14
 #define I2C_SCL 15
 #define DISPLAY_ADDR 0x3C 
+#define WIDTH 128
+#define HEIGHT 64
+
+// Matriz de LEDs WS2812 5x5 e o brilho padrão (0 a 255)
+#define MATRIZ_PIN 7
+#define MATRIZ_LADO 5
+#define MATRIZ_BRILHO 51
+
+// Períodos (ms) e prioridades das tarefas do escalonador; maior prioridade executa primeiro
+#define PERIODO_AMOSTRAGEM_MS 20
+#define PERIODO_ALARME_MS 50
+#define PERIODO_LEDS_MS 100
+#define PERIODO_DISPLAY_TEMPERATURA_MS 50
+#define PERIODO_DISPLAY_QUADRADO_MS 20
+#define PERIODO_HISTORICO_MS 500
+#define PERIODO_TELEMETRIA_MS 10
+#define PERIODO_COMANDOS_MS 20
+#define PERIODO_COMANDOS_ECONOMIA_MS 250
+
+#define PRIORIDADE_BOTOES 5
+#define PRIORIDADE_AMOSTRAGEM 4
+#define PRIORIDADE_ALARME 3
+#define PRIORIDADE_LEDS 2
+#define PRIORIDADE_HISTORICO 2
+#define PRIORIDADE_DISPLAY 1
+#define PRIORIDADE_TELEMETRIA 0
+#define PRIORIDADE_COMANDOS 0
+
+// Botões: tempo sem bordas para confirmar o nível, tempo segurando até o toque longo
+// e intervalo das repetições enquanto continua pressionado
+#define BOTOES_DEBOUNCE_US 20000
+#define BOTOES_TOQUE_LONGO_MS 1000
+#define BOTOES_REPETICAO_MS 250
+
+// Aquisição do ADC: conversões por segundo de cada canal e bits extras por sobreamostragem
+// (média de 4^n). A taxa total cresce com o número de canais, para todos serem amostrados igual
+#define ADC_TAXA_CANAL_HZ 5000
+#define ADC_SOBREAMOSTRAGEM_BITS 2
+
+// Filtro das entradas do joystick em cada bloco do DMA: mediana de 3 contra picos isolados e
+// FIR passa-baixas de 32 coeficientes (corte em 1/32 da taxa, -48 dB a 1/10) que decima as
+// 4^n amostras do bloco num valor, guardando os mesmos bits extras da sobreamostragem
+#define FILTRO_MEDIANA 3
+#define FILTRO_FIR_COEFICIENTES 32
+
+// Gráfico do histórico: uma coluna por amostra, da página 2 até acima da borda inferior.
+// A escala é fixa (0 a 50 graus) para que as colunas já desenhadas não mudem
+#define GRAFICO_X0 2
+#define GRAFICO_X1 (WIDTH - 3)
+#define GRAFICO_PAGINA0 2
+#define GRAFICO_Y0 (GRAFICO_PAGINA0 * 8)
+#define GRAFICO_Y1 (HEIGHT - 3)
+#define GRAFICO_ESCALA 500  // décimos de grau no topo do gráfico
+#define HISTORICO_EMA_SHIFT 3
+
+// Taxas de quadros da tela, em milihertz: no máximo uma por período da tarefa do display (as
+// mudanças disparadas pelos botões e pelo alarme esperam por ela) e, com a tela parada, um
+// quadro completo a cada 10 s. No baixo consumo não há quadros forçados
+#define TAXA_MAX_TEMPERATURA_MHZ (1000000 / PERIODO_DISPLAY_TEMPERATURA_MS)
+#define TAXA_MAX_QUADRADO_MHZ (1000000 / PERIODO_DISPLAY_QUADRADO_MS)
+#define TAXA_MIN_MHZ 100
+
+// Baixo consumo: intervalo inicial entre amostras, limites do comando 'i' e tempo sem usar os
+// botões até escurecer e apagar o display
+#define INTERVALO_ECONOMIA_MS 1000
+#define INTERVALO_MIN_MS 10
+#define INTERVALO_MAX_MS 60000
+#define TEMPO_ESCURECER_MS 15000
+#define TEMPO_APAGAR_MS 60000
+#define CONTRASTE_ACESA 0xFF
+#define CONTRASTE_ESCURA 0x01
+
+// Páginas do log enviadas por execução da tarefa de comandos durante um despejo
+#define DESPEJO_PAGINAS_POR_VEZ 4
+
+// Limites das faixas de temperatura em miligraus: sondas e sensor interno do RP2040
+#define LIMITE_BAIXA_MGRAUS 15000
+#define LIMITE_ALTA_MGRAUS 35000
+#define LIMITE_CHIP_BAIXA_MGRAUS 0
+#define LIMITE_CHIP_ALTA_MGRAUS 70000
+
+// Histerese e tempo mínimo além de um limite antes de mudar de faixa; a previsão avisa quando a
+// tendência das últimas amostras cruza o limite dentro do horizonte
+#define HISTERESE_MGRAUS 500
+#define PERMANENCIA_MS 200
+#define HISTERESE_CHIP_MGRAUS 2000
+#define PERMANENCIA_CHIP_MS 1000
+#define HORIZONTE_PREVISAO_MS 5000
+
+// Canais listados abaixo da temperatura principal na tela de temperatura
+#define LINHAS_CANAIS 3
+
+// Brilho do display no modo de baixo consumo
+typedef enum {
+    TELA_ACESA,
+    TELA_ESCURA,
+    TELA_APAGADA
+} brilho_t;
+
+// Canais da tabela de medição, na ordem da tabela
+enum {
+    CANAL_Y,
+    CANAL_X,
+    CANAL_ADC2,
+    CANAL_ADC3,
+    CANAL_INTERNO,
+    NUM_CANAIS
+};
+
+// Estado consumido pela renderização; no modo DUAL_CORE é copiado para o núcleo 1
+typedef struct {
+    estado_t estado;
+    faixa_t faixa;
+    faixa_t faixa_prevista;  // faixa que a tendência deve alcançar (normal sem previsão)
+    brilho_t brilho;
+    int32_t canais[NUM_CANAIS];  // valor de cada canal (miligraus)
+    sensor_range_t canais_faixa[NUM_CANAIS];
+    int32_t temperatura;  // miligraus
+    uint16_t adc_x, adc_y;
+    // Histórico em décimos de grau: número de amostras e estatísticas da janela
+    uint32_t historico_total;
+    int16_t historico_min, historico_max, historico_media;
+    bool quadro_completo;  // reenviar o quadro inteiro (taxa mínima da tela)
+} instantaneo_t;
+
+// Modelo da tela: só o que aparece nela, já no formato exibido. Um quadro só é desenhado quando
+// o modelo muda; os campos das outras telas ficam zerados para não contarem como mudança
+typedef struct {
+    estado_t estado;
+    brilho_t brilho;
+    faixa_t faixa, faixa_prevista;  // cor da matriz no modo DUAL_CORE
+    int32_t graus;  // temperatura principal
+    int32_t canais_graus[NUM_CANAIS];
+    sensor_range_t canais_faixa[NUM_CANAIS];
+    uint8_t quadrado_x, quadrado_y;
+    uint32_t historico_total;
+    int16_t historico_min, historico_max, historico_media;  // graus
+} visao_t;
+
+// Etapas medidas com TIMING=1 (despejadas pelo comando 't'); sem ele não geram código
+TIMING_STAGE(etapa_adc, "adc");
+TIMING_STAGE(etapa_conversao, "conversao");
+TIMING_STAGE(etapa_printf, "printf");
+TIMING_STAGE(etapa_leds, "leds");
+TIMING_STAGE(etapa_matriz, "matriz");
+TIMING_STAGE(etapa_desenho, "desenho");
+TIMING_STAGE(etapa_envio, "envio");
 
 // Variáveis Globais
 uint border_size = 2;
-volatile uint32_t ultimo_tempo_A = 0;
-volatile uint32_t ultimo_tempo_B = 0;
-const uint32_t debounce = 200;
 uint16_t adc_x, adc_y;
 bool escolha_feita = false;
-bool menu_quadrado = false;
+uint16_t valor_adc;
+int32_t temperatura_simulada;  // miligraus
+faixa_t faixa = FAIXA_NORMAL;
+faixa_t faixa_prevista = FAIXA_NORMAL;
+uint32_t sequencia_alarme;  // último bloco do ADC avaliado pelo alarme
+volatile estado_t estado = ESTADO_TEMPERATURA;
+estado_t estado_exibido = ESTADO_TEMPERATURA;
+int tarefa_amostragem_id, tarefa_alarme_id, tarefa_leds_id, tarefa_display_id, tarefa_comandos_id;
+int tarefa_botoes_id = -1;
+int entrada_botao_a, entrada_botao_b;  // índices dos botões no subsistema de entrada
+int tarefa_telemetria_id = -1;
+
+// Modo de consumo e intervalo de amostragem, ajustáveis pela serial
+bool modo_economia = BAIXO_CONSUMO;
+uint32_t intervalo_amostragem_ms = BAIXO_CONSUMO ? INTERVALO_ECONOMIA_MS : PERIODO_AMOSTRAGEM_MS;
+volatile uint32_t ultima_atividade_ms;  // último toque nos botões
+brilho_t brilho_exibido = TELA_ACESA;
+
+// Display OLED e matriz WS2812
+ssd1306_t ssd;
+ws2812_t matriz;
+
+// Histórico da temperatura, escrito pelo núcleo 0 e lido pela renderização
+history_t historico;
+
+// Partes fixas (rótulos, borda) são desenhadas só ao montar a tela; -1 força a montagem
+int tela_montada = -1;
+ssd1306_text_field_t campo_temperatura;
+ssd1306_text_field_t campo_estatisticas;
+ssd1306_text_field_t campo_canais[LINHAS_CANAIS];
+ssd1306_sprite_t sprite_quadrado;  // quadrado do menu do joystick
+uint32_t grafico_total;  // amostras do histórico já desenhadas no gráfico
+
+// Atualização conduzida por mudanças: modelo do último quadro, controle da taxa de quadros e o
+// que está aceso no LED RGB (bits R, G, B; 0xFF antes do primeiro acionamento) e na matriz
+visao_t ultima_visao;
+refresh_governor_t controle_tela;
+uint8_t leds_acesos = 0xFF;
+uint32_t cor_matriz_exibida = UINT32_MAX;
+// Quadro desenhado que não saiu porque o envio anterior ocupava o barramento
+volatile bool quadro_pendente;
+
+// Próxima página do log a despejar pela serial; -1 sem despejo em andamento
+int32_t despejo_pagina = -1;
+// Valor do comando 'i' sendo digitado; -1 fora do comando
+int32_t comando_intervalo = -1;
+
+#if DUAL_CORE
+static snapshot_queue_t fila_instantaneos;
+static uint8_t fila_instantaneos_mem[SNAPSHOT_QUEUE_SLOTS * sizeof(instantaneo_t)];
+#endif
+
+// Curvas dos canais: o joystick simula 0 a 50 graus em toda a faixa do ADC.
+// Para um termistor NTC 10k (B = 3950) com resistor de 10k: CALIB_TABLE(CALIB_NTC_BETA, 3950, 10000, 10000)
+static const calib_table_t calibracao_temperatura = CALIB_TABLE(CALIB_LINEAR, 0, 50000);
+
+// Coeficientes do FIR do joystick (Q15, janela de Hamming, soma 32768 para ganho unitário em DC)
+static const int16_t fir_joystick[FILTRO_FIR_COEFICIENTES] = {
+    6, 23, 51, 104, 189, 313, 482, 692, 940, 1213, 1497, 1774, 2026, 2234, 2382, 2458,
+    2458, 2382, 2234, 2026, 1774, 1497, 1213, 940, 692, 482, 313, 189, 104, 51, 23, 6,
+};
+
+// Estado do filtro de uma entrada do joystick, entre um bloco e o seguinte
+typedef struct {
+    dsp_median_t mediana;
+    dsp_fir_t fir;
+} filtro_joystick_t;
+
+static filtro_joystick_t filtro_y, filtro_x;
+static const calib_table_t calibracao_interna = CALIB_TABLE(CALIB_RP2040_TEMP, 3300);
+
+// Alarme das sondas: faixa normal de 15 a 35 graus, com previsão. O sensor interno só avisa
+// acima de 70 graus, com histerese e permanência maiores por ser mais ruidoso
+static const alarm_config_t alarme_sonda = {
+    .low = {LIMITE_BAIXA_MGRAUS, HISTERESE_MGRAUS, PERMANENCIA_MS},
+    .high = {LIMITE_ALTA_MGRAUS, HISTERESE_MGRAUS, PERMANENCIA_MS},
+    .predict_ms = HORIZONTE_PREVISAO_MS,
+};
+static const alarm_config_t alarme_chip = {
+    .low = {LIMITE_CHIP_BAIXA_MGRAUS, HISTERESE_CHIP_MGRAUS, PERMANENCIA_CHIP_MS},
+    .high = {LIMITE_CHIP_ALTA_MGRAUS, HISTERESE_CHIP_MGRAUS, PERMANENCIA_CHIP_MS},
+};
+
+// Tabela de canais, todos convertidos na mesma varredura round-robin do ADC. O eixo Y do
+// joystick é a temperatura principal (tela, histórico e log) e o eixo X, que também move o
+// quadrado, é uma segunda sonda simulada sem alarme. ADC2 (GPIO 28) e ADC3 (GPIO 29) ficam
+// prontos para sondas externas; na Pico W o GPIO 29 é compartilhado com o módulo sem fio
+sensor_channel_t canais[NUM_CANAIS] = {
+    [CANAL_Y] = {.name = "Y", .input = 0, .calib = &calibracao_temperatura, .enabled = true,
+        .alarm.config = &alarme_sonda},
+    [CANAL_X] = {.name = "X", .input = 1, .calib = &calibracao_temperatura, .enabled = true},
+    [CANAL_ADC2] = {.name = "ADC2", .input = 2, .calib = &calibracao_temperatura, .filter_shift = 2,
+        .alarm.config = &alarme_sonda},
+    [CANAL_ADC3] = {.name = "ADC3", .input = 3, .calib = &calibracao_temperatura, .filter_shift = 2,
+        .alarm.config = &alarme_sonda},
+    [CANAL_INTERNO] = {.name = "CPU", .input = 4, .calib = &calibracao_interna, .filter_shift = 4, .enabled = true,
+        .alarm.config = &alarme_chip},
+};
+
+// Faixa do alarme correspondente à faixa de um canal
+static const faixa_t faixa_do_canal[] = {
+    [SENSOR_RANGE_LOW] = FAIXA_BAIXA,
+    [SENSOR_RANGE_NORMAL] = FAIXA_NORMAL,
+    [SENSOR_RANGE_HIGH] = FAIXA_ALTA,
+};
+
+// Padrão do alarme de temperatura alta: 350 ms de tom seguidos de 50 ms de silêncio
+const buzzer_note_t alerta_alta[] = {
+    {500, 350, 50},
+    {0, 50, 0},
+};
+
+// Aviso da previsão de temperatura alta: um bipe curto e agudo, tocado uma vez
+const buzzer_note_t aviso_previsao[] = {
+    {2000, 60, 50},
+};
 
+// Escreve o valor da temperatura (em miligraus, exibido em graus inteiros); só as células
+// que mudaram são redesenhadas
 void texto_temperatura(int temperatura_simulada){
+    temperatura_simulada /= 1000;
     char buffer[32];
-    ssd1306_draw_string(&ssd, "Temperatura: ", 10, 10);
     if(temperatura_simulada > 1){
         sprintf(buffer, "%d Graus", temperatura_simulada);
     } else {
         sprintf(buffer, "%d Grau", temperatura_simulada);
     }
-    ssd1306_draw_string(&ssd, buffer, 10, 20);
+    ssd1306_text_field_draw(&ssd, &campo_temperatura, buffer);
+}
+
+// Lista os demais canais habilitados, um por linha, com a faixa dos que estão fora do normal
+void texto_canais(const instantaneo_t *instantaneo){
+    uint linha = 0;
+    for (uint canal = 0; canal < NUM_CANAIS && linha < LINHAS_CANAIS; canal++) {
+        if (canal == CANAL_Y || !canais[canal].enabled) {
+            continue;
+        }
+        const char *aviso = instantaneo->canais_faixa[canal] == SENSOR_RANGE_HIGH ? "alta" :
+            instantaneo->canais_faixa[canal] == SENSOR_RANGE_LOW ? "baixa" : "";
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%-4s%4ld %s", canais[canal].name, (long)(instantaneo->canais[canal] / 1000), aviso);
+        ssd1306_text_field_draw(&ssd, &campo_canais[linha++], buffer);
+    }
 }
 
 void desenha_borda(){
@@ -58,37 +382,707 @@ void desenha_borda(){
     }
 }
 
-// Função para gerar tons no buzzer
-void tone(uint buzzer, uint frequencia, uint duracao) {
-    uint32_t periodo = 1000000 / frequencia; 
-    uint32_t meio_periodo = periodo / 2;    
-    uint32_t ciclos = frequencia * duracao / 1000;
+// Maior entre o período normal da tarefa e o intervalo de amostragem no modo de baixo consumo
+static uint32_t periodo_economia_ms(uint32_t periodo_ms)
+{
+    return modo_economia && intervalo_amostragem_ms > periodo_ms ? intervalo_amostragem_ms : periodo_ms;
+}
 
-    for (uint32_t i = 0; i < ciclos; i++) {
-        gpio_put(buzzer, 1); 
-        sleep_us(meio_periodo);
-        gpio_put(buzzer, 0); 
-        sleep_us(meio_periodo);
+// Ajusta os períodos das tarefas ao modo de consumo e à tela. No baixo consumo o alarme, os
+// LEDs, o display e a telemetria acompanham o intervalo de amostragem, pois nada muda entre
+// duas amostras; o menu do quadrado segue o joystick na taxa normal
+void aplica_periodos(void)
+{
+    bool interativo = estado_exibido == ESTADO_QUADRADO;
+    scheduler_set_period(tarefa_amostragem_id, 1000 * (interativo ? PERIODO_AMOSTRAGEM_MS : intervalo_amostragem_ms));
+    scheduler_set_period(tarefa_alarme_id, 1000 * periodo_economia_ms(PERIODO_ALARME_MS));
+    scheduler_set_period(tarefa_leds_id, 1000 * periodo_economia_ms(PERIODO_LEDS_MS));
+    scheduler_set_period(tarefa_display_id, 1000 * (interativo ? PERIODO_DISPLAY_QUADRADO_MS :
+        periodo_economia_ms(PERIODO_DISPLAY_TEMPERATURA_MS)));
+    scheduler_set_period(tarefa_comandos_id, 1000 * (modo_economia ? PERIODO_COMANDOS_ECONOMIA_MS : PERIODO_COMANDOS_MS));
+    refresh_set_rates(&controle_tela, modo_economia ? 0 : TAXA_MIN_MHZ,
+        interativo ? TAXA_MAX_QUADRADO_MHZ : TAXA_MAX_TEMPERATURA_MHZ);
+    if (tarefa_telemetria_id >= 0) {
+        scheduler_set_period(tarefa_telemetria_id, 1000 * periodo_economia_ms(PERIODO_TELEMETRIA_MS));
     }
 }
 
-// Função de callback para os botões A e B
-void button_callback(uint gpio, uint32_t events){
-    uint32_t tempo_atual = to_ms_since_boot(get_absolute_time());
-    if(gpio == BOTAO_A && (tempo_atual - ultimo_tempo_A > debounce)){
-        ultimo_tempo_A = tempo_atual;
-        menu_quadrado = true;
+// Troca o modo de consumo e o intervalo de amostragem. A aquisição contínua só roda fora do
+// baixo consumo; nele cada amostra converte um bloco e o ADC e o DMA ficam parados no intervalo
+void define_modo(bool economia, uint32_t intervalo_ms)
+{
+    if (intervalo_ms < INTERVALO_MIN_MS) {
+        intervalo_ms = INTERVALO_MIN_MS;
+    } else if (intervalo_ms > INTERVALO_MAX_MS) {
+        intervalo_ms = INTERVALO_MAX_MS;
     }
-    if(gpio == BOTAO_B && (tempo_atual - ultimo_tempo_B > debounce)){
-        ultimo_tempo_B = tempo_atual;
-        menu_quadrado = false;
+
+    adc_acq_stop();
+    modo_economia = economia;
+    intervalo_amostragem_ms = intervalo_ms;
+    ultima_atividade_ms = to_ms_since_boot(get_absolute_time());
+    if (!modo_economia) {
+        adc_acq_start();
     }
+    aplica_periodos();
 }
 
-int main()
+// Brilho do display conforme o tempo sem usar os botões. Fora do modo de baixo consumo, e
+// com a temperatura na faixa alta, o display fica aceso
+brilho_t brilho_atual(void)
 {
-    stdio_init_all();
+    if (!modo_economia || faixa == FAIXA_ALTA) {
+        return TELA_ACESA;
+    }
+    uint32_t ocioso = to_ms_since_boot(get_absolute_time()) - ultima_atividade_ms;
+    if (ocioso >= TEMPO_APAGAR_MS) {
+        return TELA_APAGADA;
+    }
+    return ocioso >= TEMPO_ESCURECER_MS ? TELA_ESCURA : TELA_ACESA;
+}
+
+// Chamada pelo alarme de debounce a cada evento novo dos botões
+static void notifica_botoes(void)
+{
+    scheduler_trigger(tarefa_botoes_id);
+}
+
+// Tarefa dos botões: só executa quando há eventos na fila. Pressionar A abre o quadrado;
+// pressionar B alterna entre a temperatura e o histórico, e segurar B liga ou desliga o
+// baixo consumo
+void tarefa_botoes(void *dados)
+{
+    (void)dados;
+    input_event_t evento;
+    bool mudou = false;
+
+    while (input_pop(&evento)) {
+        // Com o display escuro ou apagado, o toque só acende a tela
+        bool acordando = brilho_atual() != TELA_ACESA;
+        ultima_atividade_ms = to_ms_since_boot(get_absolute_time());
+        mudou = true;
+        if (acordando) {
+            continue;
+        }
+
+        if (evento.button == entrada_botao_a && evento.type == INPUT_PRESS) {
+            estado = ESTADO_QUADRADO;
+        } else if (evento.button == entrada_botao_b && evento.type == INPUT_PRESS) {
+            // Na tela de temperatura o botão B abre o histórico; nas outras volta à temperatura
+            estado = estado == ESTADO_TEMPERATURA ? ESTADO_HISTORICO : ESTADO_TEMPERATURA;
+        } else if (evento.button == entrada_botao_b && evento.type == INPUT_LONG_PRESS) {
+            define_modo(!modo_economia, intervalo_amostragem_ms);
+        }
+    }
+
+    // A troca de tela aparece sem esperar o próximo período
+    if (mudou) {
+        scheduler_trigger(tarefa_leds_id);
+        scheduler_trigger(tarefa_display_id);
+    }
+}
+
+// Tarefa de amostragem: copia os últimos valores filtrados da aquisição. No modo de baixo
+// consumo o ADC está parado e converte um bloco só agora, dormindo até o fim da conversão
+void tarefa_amostragem(void *dados)
+{
+    (void)dados;
+    TIMING_BEGIN(inicio_adc);
+    if (modo_economia) {
+        adc_acq_capture();
+    }
+    valor_adc = adc_acq_read(canais[CANAL_Y].input);
+    adc_y = valor_adc;
+    adc_x = adc_acq_read(canais[CANAL_X].input);
+    TIMING_END(etapa_adc, inicio_adc);
+
+    // Conversão em ponto fixo de todos os canais com os bits extras da sobreamostragem. O
+    // instante do bloco é lido antes dos valores: se um bloco novo chegar no meio, a latência
+    // medida pelo alarme fica maior, nunca menor
+    TIMING_BEGIN(inicio_conversao);
+    uint32_t sequencia = adc_acq_sequence();
+    uint32_t instante_amostra = adc_acq_timestamp();
+    sensor_update(canais, NUM_CANAIS);
+    temperatura_simulada = canais[CANAL_Y].value;
+    TIMING_END(etapa_conversao, inicio_conversao);
+
+    // O alarme avalia cada bloco novo uma única vez, logo depois da conversão; uma mudança de
+    // estado dispara a tarefa de alarme, sem esperar pelo período dela
+    if (sequencia != sequencia_alarme) {
+        sequencia_alarme = sequencia;
+        sensor_check_alarms(canais, NUM_CANAIS, instante_amostra);
+    }
+
+    // Exibe mensagens de depuração no terminal serial; sem DEBUG os valores nem são calculados
+    TIMING_BEGIN(inicio_printf);
+#if DEBUG
+    if (estado != ESTADO_QUADRADO) {
+        uint32_t bruto = adc_acq_read_raw(canais[CANAL_Y].input);
+        uint32_t tensao_mv = calib_millivolts(bruto, adc_acq_bits());
+        int32_t t = temperatura_simulada < 0 ? -temperatura_simulada : temperatura_simulada;
+        DEBUG_PRINT("ADC: %d | Tensão: %lu.%02luV | Temperatura Simulada: %s%ld.%02ld\n", valor_adc,
+            (unsigned long)(tensao_mv / 1000), (unsigned long)(tensao_mv % 1000 / 10),
+            temperatura_simulada < 0 ? "-" : "", (long)(t / 1000), (long)(t % 1000 / 10));
+        for (uint canal = 0; canal < NUM_CANAIS; canal++) {
+            if (canal != CANAL_Y && canais[canal].enabled) {
+                DEBUG_PRINT("  Canal %s: %ld mC\n", canais[canal].name, (long)canais[canal].value);
+            }
+        }
+    } else {
+        DEBUG_PRINT("ADC X: %d | ADC Y: %d\n", adc_x, adc_y);
+    }
+#endif
+    TIMING_END(etapa_printf, inicio_printf);
+}
+
+// LED RGB conforme a tela e a faixa; a faixa prevista soma o verde à cor dela. Os pinos só
+// são escritos quando a cor muda
+static void aciona_leds(void)
+{
+    bool vermelho, verde, azul;
+    if (brilho_atual() == TELA_APAGADA) {
+        vermelho = verde = azul = false;
+    } else if (estado == ESTADO_QUADRADO) {
+        // Definição dos Leds em branco
+        vermelho = verde = azul = true;
+    } else if (faixa == FAIXA_BAIXA) {
+        vermelho = verde = false;
+        azul = true;
+    } else if (faixa == FAIXA_ALTA) {
+        vermelho = true;
+        verde = azul = false;
+    } else if (faixa_prevista == FAIXA_ALTA) {
+        // Amarelo: ainda normal, mas subindo para a faixa alta
+        vermelho = verde = true;
+        azul = false;
+    } else if (faixa_prevista == FAIXA_BAIXA) {
+        // Ciano: ainda normal, mas descendo para a faixa baixa
+        vermelho = false;
+        verde = azul = true;
+    } else {
+        vermelho = azul = false;
+        verde = true;
+    }
+
+    uint8_t acesos = vermelho << 2 | verde << 1 | azul;
+    if (acesos == leds_acesos) {
+        return;
+    }
+    leds_acesos = acesos;
+    gpio_put(LED_RED, vermelho);
+    gpio_put(LED_GREEN, verde);
+    gpio_put(LED_BLUE, azul);
+}
+
+// Chamada pelo motor de alarme a cada mudança de estado de um canal
+static void notifica_alarme(void)
+{
+    scheduler_trigger(tarefa_alarme_id);
+}
+
+// Reenfileira o padrão do alarme enquanto a faixa for alta; ele toca em segundo plano
+static void aciona_buzzer(void)
+{
+    if (estado != ESTADO_QUADRADO && faixa == FAIXA_ALTA && !buzzer_busy()) {
+        buzzer_play(alerta_alta, 2);
+    }
+}
+
+// Tarefa de alarme: consome os eventos do motor de alarme e aciona os LEDs e o buzzer na hora.
+// A faixa geral é a mais grave entre os canais; a prevista acende a cor de aviso e, para a
+// faixa alta, toca um bipe curto. O período só reenfileira o padrão do buzzer
+void tarefa_alarme(void *dados)
+{
+    (void)dados;
+    alarm_event_t evento;
+    bool mudou = false;
+
+    while (alarm_pop(&evento)) {
+        faixa = faixa_do_canal[sensor_worst_range(canais, NUM_CANAIS)];
+        faixa_prevista = faixa_do_canal[sensor_predicted_range(canais, NUM_CANAIS)];
+        aciona_leds();
+        if (evento.to == ALARM_PREDICT_HIGH && estado != ESTADO_QUADRADO && !buzzer_busy()) {
+            buzzer_play(aviso_previsao, 1);
+        }
+        aciona_buzzer();
+        alarm_actuated(&evento);
+        mudou = true;
+    }
+
+    // A matriz e a tela acompanham sem esperar o próximo período
+    if (mudou) {
+        scheduler_trigger(tarefa_leds_id);
+        scheduler_trigger(tarefa_display_id);
+    }
+    aciona_buzzer();
+}
+
+// Grava a página completa do log na flash. Durante a gravação (e o apagamento de um setor,
+// a cada 15 páginas) as interrupções ficam desligadas e o DMA do ADC não é rearmado, então a
+// aquisição é pausada e retomada em vez de deixar os buffers transbordarem
+static void grava_log(void)
+{
+    adc_acq_stop();
+    flash_log_commit();
+    if (!modo_economia) {
+        adc_acq_start();
+    }
+}
+
+// Tarefa do histórico: guarda uma amostra da temperatura para o gráfico e para o log na flash
+void tarefa_historico(void *dados)
+{
+    (void)dados;
+    int16_t decimos = (int16_t)(temperatura_simulada / 100);
+    history_push(&historico, decimos);
+
+    // Os registros ficam na RAM até completar uma página (32 amostras, 16 s)
+    if (flash_log_append(decimos, faixa)) {
+        grava_log();
+    }
+    DEBUG_PRINT("Histórico: min %d | max %d | média %d | EMA %d (décimos de grau)\n",
+        history_min(&historico), history_max(&historico), history_mean(&historico), history_ema(&historico));
+}
+
+// Transporte da telemetria e do despejo do log: escreve na porta CDC só o que cabe no FIFO da
+// USB, sem esperar
+static uint32_t telemetria_escreve(const uint8_t *dados, uint32_t tamanho)
+{
+    if (!tud_cdc_connected())
+        return 0;
+
+    uint32_t livre = tud_cdc_write_available();
+    if (tamanho > livre)
+        tamanho = livre;
+    if (tamanho)
+        stdio_usb.out_chars((const char *)dados, tamanho);
+    return tamanho;
+}
+
+#if TELEMETRIA
+// Chamada na interrupção do ADC a cada bloco: registra as leituras com a resolução completa
+static void telemetria_bloco(void)
+{
+    uint16_t brutos[TELEMETRY_CHANNELS] = {adc_acq_read_raw(canais[CANAL_Y].input), adc_acq_read_raw(canais[CANAL_X].input)};
+    telemetry_record(time_us_32(), brutos, estado | faixa << 4);
+}
+
+// Tarefa da telemetria: entrega os pacotes prontos à USB
+void tarefa_telemetria(void *dados)
+{
+    (void)dados;
+    telemetry_poll();
+}
+#endif
+
+#if !TELEMETRIA
+// Quadro da página em despejo e quanto dele já foi aceito pela USB
+static uint8_t quadro_despejo[1 + TELEMETRY_MAX_ENCODED];
+static uint32_t quadro_despejo_tamanho;
+static uint32_t quadro_despejo_enviado;
+#endif
+
+// Envia uma página do log inteira num quadro TELEMETRY_MESSAGE_LOG_PAGE, lido por
+// telemetry_decode -l. Com TELEMETRIA ela entra no fluxo da telemetria; sem, vai direto para a
+// porta CDC, com um 0x00 antes que separa o quadro do texto anterior. Retorna false se a página
+// ainda não saiu toda (a mesma página é passada de novo na próxima execução)
+static bool despeja_pagina(const uint8_t *pagina)
+{
+#if TELEMETRIA
+    return telemetry_send(TELEMETRY_MESSAGE_LOG_PAGE, pagina, FLASH_PAGE_SIZE);
+#else
+    if (!quadro_despejo_tamanho) {
+        quadro_despejo[0] = 0x00;
+        quadro_despejo_tamanho = 1 + telemetry_encode_message(TELEMETRY_MESSAGE_LOG_PAGE, pagina, FLASH_PAGE_SIZE,
+            &quadro_despejo[1]);
+        quadro_despejo_enviado = 0;
+    }
+
+    quadro_despejo_enviado += telemetria_escreve(&quadro_despejo[quadro_despejo_enviado],
+        quadro_despejo_tamanho - quadro_despejo_enviado);
+    if (quadro_despejo_enviado < quadro_despejo_tamanho) {
+        return false;
+    }
+    quadro_despejo_tamanho = 0;
+    return true;
+#endif
+}
+
+// Mostra o ciclo de trabalho medido pelo escalonador e o tempo de cada tarefa
+static void imprime_consumo(void)
+{
+#if !TELEMETRIA
+    scheduler_stats_t consumo;
+    scheduler_get_stats(&consumo);
+    uint32_t ativo = scheduler_duty_permille();
+    printf("Consumo: %lu.%lu%% ativo | %lu ms dormindo de %lu ms | %lu despertares\n",
+        (unsigned long)(ativo / 10), (unsigned long)(ativo % 10), (unsigned long)(consumo.idle_us / 1000),
+        (unsigned long)(consumo.elapsed_us / 1000), (unsigned long)consumo.wakeups);
+    for (int tarefa = 0; tarefa < SCHEDULER_MAX_TASKS && scheduler_get(tarefa)->fn; ++tarefa) {
+        printf("  %s: %lu execuções, %lu us\n", scheduler_get(tarefa)->name,
+            (unsigned long)scheduler_get(tarefa)->runs, (unsigned long)scheduler_get(tarefa)->busy_us);
+    }
+
+    // Latência da borda no GPIO até a tarefa dos botões tratar o evento (inclui o debounce)
+    input_stats_t entrada;
+    input_get_stats(&entrada);
+    printf("Botões: %lu eventos, %lu bordas (%lu repiques) | latência média %lu us, máx %lu us, "
+        "máx na fila %lu us | %lu descartados\n",
+        (unsigned long)entrada.handled, (unsigned long)entrada.edges, (unsigned long)entrada.bounces,
+        (unsigned long)(entrada.handled ? entrada.latency_sum_us / entrada.handled : 0),
+        (unsigned long)entrada.latency_max_us, (unsigned long)entrada.queue_max_us,
+        (unsigned long)(entrada.dropped_edges + entrada.dropped_events));
+
+    // Latência da amostra (bloco do ADC) até os LEDs e o buzzer serem acionados
+    alarm_stats_t alarme;
+    alarm_get_stats(&alarme);
+    printf("Alarme: %lu eventos (%lu previsões), %lu oscilações evitadas | latência média %lu us, "
+        "máx %lu us | %lu descartados\n",
+        (unsigned long)alarme.events, (unsigned long)alarme.predictions, (unsigned long)alarme.suppressed,
+        (unsigned long)(alarme.actuated ? alarme.latency_sum_us / alarme.actuated : 0),
+        (unsigned long)alarme.latency_max_us, (unsigned long)alarme.dropped);
+
+    // Transações I2C do display desde a partida (a configuração conta uma só) e quadros da tela
+    refresh_stats_t tela = controle_tela.stats;
+    uint32_t pulados = refresh_skipped_permille(&controle_tela);
+    printf("Display: %lu transações I2C | %lu quadros avaliados, %lu desenhados, %lu completos, "
+        "%lu pulados (%lu.%lu%%), %lu adiados\n",
+        (unsigned long)ssd.transactions, (unsigned long)tela.evaluated, (unsigned long)tela.rendered,
+        (unsigned long)tela.forced, (unsigned long)tela.skipped, (unsigned long)(pulados / 10),
+        (unsigned long)(pulados % 10), (unsigned long)tela.deferred);
+#endif
+}
 
+// Despeja e zera os tempos das etapas (com TIMING=1)
+static void imprime_tempos(void)
+{
+#if !TELEMETRIA
+    timing_dump();
+#endif
+    timing_reset();
+}
+
+// Tarefa de comandos pela serial:
+//   'd'        despeja o log da flash, do registro mais antigo ao atual
+//   'e'        liga ou desliga o modo de baixo consumo
+//   'i<ms>'    define o intervalo de amostragem (terminado por Enter)
+//   's'        mostra o ciclo de trabalho e zera a medição
+//   't'        mostra os tempos de cada etapa (compilado com TIMING=1) e zera a medição
+void tarefa_comandos(void *dados)
+{
+    (void)dados;
+    int comando;
+    while ((comando = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT) {
+        if (comando_intervalo >= 0 && comando >= '0' && comando <= '9') {
+            if (comando_intervalo <= INTERVALO_MAX_MS) {
+                comando_intervalo = comando_intervalo * 10 + (comando - '0');
+            }
+        } else if (comando_intervalo >= 0 && (comando == '\r' || comando == '\n')) {
+            define_modo(modo_economia, comando_intervalo);
+            comando_intervalo = -1;
+        } else if (comando == 'i') {
+            comando_intervalo = 0;
+        } else if (comando == 'e') {
+            define_modo(!modo_economia, intervalo_amostragem_ms);
+        } else if (comando == 's') {
+            imprime_consumo();
+            scheduler_reset_stats();
+            input_reset_stats();
+            alarm_reset_stats();
+            refresh_reset_stats(&controle_tela);
+        } else if (comando == 't') {
+            imprime_tempos();
+        } else if (comando == 'd' && despejo_pagina < 0) {
+            despejo_pagina = 0;
+        }
+    }
+
+    for (uint n = 0; n < DESPEJO_PAGINAS_POR_VEZ && despejo_pagina >= 0; ++n) {
+        const uint8_t *pagina = flash_log_page(despejo_pagina);
+        if (!pagina) {
+            despejo_pagina = -1;
+        } else if (despeja_pagina(pagina)) {
+            despejo_pagina++;
+        } else {
+            break;
+        }
+    }
+}
+
+// Copia o estado atual usado pela renderização
+void captura_instantaneo(instantaneo_t *instantaneo)
+{
+    instantaneo->estado = estado;
+    instantaneo->faixa = faixa;
+    instantaneo->faixa_prevista = faixa_prevista;
+    instantaneo->brilho = brilho_atual();
+    for (uint canal = 0; canal < NUM_CANAIS; canal++) {
+        instantaneo->canais[canal] = canais[canal].value;
+        instantaneo->canais_faixa[canal] = canais[canal].range;
+    }
+    instantaneo->temperatura = temperatura_simulada;
+    instantaneo->adc_x = adc_x;
+    instantaneo->adc_y = adc_y;
+    instantaneo->historico_total = history_total(&historico);
+    instantaneo->historico_min = history_min(&historico);
+    instantaneo->historico_max = history_max(&historico);
+    instantaneo->historico_media = history_mean(&historico);
+}
+
+// Cor da matriz WS2812 conforme a tela e a faixa de temperatura; a matriz só é preenchida e
+// reenviada quando a cor muda
+void atualiza_matriz(const instantaneo_t *instantaneo)
+{
+    TIMING_BEGIN(inicio_matriz);
+    uint32_t cor;
+    if (instantaneo->brilho == TELA_APAGADA) {
+        cor = 0;
+    } else if (instantaneo->estado == ESTADO_QUADRADO) {
+        cor = WS2812_WHITE;
+    } else if (instantaneo->faixa == FAIXA_BAIXA) {
+        cor = WS2812_BLUE; // Acende a matriz de led na cor azul
+    } else if (instantaneo->faixa == FAIXA_ALTA) {
+        cor = WS2812_RED; // Acende a matriz de led na cor vermelha
+    } else if (instantaneo->faixa_prevista == FAIXA_ALTA) {
+        cor = WS2812_YELLOW; // Previsão da faixa alta
+    } else if (instantaneo->faixa_prevista == FAIXA_BAIXA) {
+        cor = WS2812_CYAN; // Previsão da faixa baixa
+    } else {
+        cor = WS2812_GREEN; // Acende a matriz de led na cor verde
+    }
+
+    if (cor != cor_matriz_exibida) {
+        ws2812_set_color(&matriz, cor);
+        cor_matriz_exibida = cor;
+    }
+    TIMING_END(etapa_matriz, inicio_matriz);
+}
+
+// Posição do quadrado no display para as leituras do joystick, dentro da borda
+static void posicao_quadrado(uint16_t adc_x, uint16_t adc_y, uint8_t *x, uint8_t *y)
+{
+    *x = border_size + (adc_x * (WIDTH - 8 - 2 * border_size)) / 4095;
+    *y = border_size + ((4095 - adc_y) * (HEIGHT - 8 - 2 * border_size)) / 4095;
+}
+
+// Monta o modelo da tela do instantâneo, com os valores como aparecem nela
+void monta_visao(const instantaneo_t *instantaneo, visao_t *visao)
+{
+    memset(visao, 0, sizeof(*visao));
+    visao->estado = instantaneo->estado;
+    visao->brilho = instantaneo->brilho;
+    visao->faixa = instantaneo->faixa;
+    visao->faixa_prevista = instantaneo->faixa_prevista;
+    if (instantaneo->brilho == TELA_APAGADA) {
+        return;
+    }
+
+    if (instantaneo->estado == ESTADO_TEMPERATURA) {
+        visao->graus = instantaneo->temperatura / 1000;
+        for (uint canal = 0; canal < NUM_CANAIS; canal++) {
+            visao->canais_graus[canal] = instantaneo->canais[canal] / 1000;
+            visao->canais_faixa[canal] = instantaneo->canais_faixa[canal];
+        }
+    } else if (instantaneo->estado == ESTADO_HISTORICO) {
+        visao->historico_total = instantaneo->historico_total;
+        visao->historico_min = instantaneo->historico_min / 10;
+        visao->historico_max = instantaneo->historico_max / 10;
+        visao->historico_media = instantaneo->historico_media / 10;
+    } else {
+        posicao_quadrado(instantaneo->adc_x, instantaneo->adc_y, &visao->quadrado_x, &visao->quadrado_y);
+    }
+}
+
+// Desenha a coluna x do gráfico como uma barra proporcional ao valor (décimos de grau)
+void desenha_coluna(uint8_t x, int16_t valor)
+{
+    int altura = valor * (GRAFICO_Y1 - GRAFICO_Y0) / GRAFICO_ESCALA;
+    if (altura < 0)
+        altura = 0;
+    if (altura > GRAFICO_Y1 - GRAFICO_Y0)
+        altura = GRAFICO_Y1 - GRAFICO_Y0;
+
+    ssd1306_vline(&ssd, x, GRAFICO_Y0, GRAFICO_Y1, false);
+    ssd1306_vline(&ssd, x, GRAFICO_Y1 - altura, GRAFICO_Y1, true);
+}
+
+// Redesenha o gráfico inteiro com as últimas amostras; a mais recente fica à direita.
+// O gráfico é mais estreito que o histórico, então as amostras lidas não estão sendo sobrescritas
+void desenha_grafico(uint32_t total)
+{
+    for (uint8_t x = GRAFICO_X0; x <= GRAFICO_X1; ++x) {
+        uint32_t idade = GRAFICO_X1 - x;
+        if (idade < total)
+            desenha_coluna(x, history_at(&historico, total - 1 - idade));
+        else
+            ssd1306_vline(&ssd, x, GRAFICO_Y0, GRAFICO_Y1, false);
+    }
+    grafico_total = total;
+}
+
+// Tela do histórico: uma amostra nova rola o gráfico no próprio painel e só a última coluna é enviada
+void tela_historico(const instantaneo_t *instantaneo)
+{
+    uint32_t total = instantaneo->historico_total;
+
+    if (tela_montada != ESTADO_HISTORICO) {
+        ssd1306_fill(&ssd, false);
+        desenha_borda();
+        ssd1306_text_field_invalidate(&campo_estatisticas);
+        desenha_grafico(total);
+    } else if (total == grafico_total + 1) {
+        ssd1306_scroll_left(&ssd, GRAFICO_X0, GRAFICO_X1, GRAFICO_PAGINA0, ssd.pages - 1);
+        desenha_coluna(GRAFICO_X1, history_at(&historico, total - 1));
+        grafico_total = total;
+    } else if (total != grafico_total) {
+        // Mais de uma amostra nova (renderização atrasada): redesenha tudo
+        desenha_grafico(total);
+    }
+
+    char buffer[32];
+    sprintf(buffer, "Mn%d Md%d Mx%d", instantaneo->historico_min / 10,
+        instantaneo->historico_media / 10, instantaneo->historico_max / 10);
+    ssd1306_text_field_draw(&ssd, &campo_estatisticas, buffer);
+}
+
+// Desenha a tela do instantâneo e envia por DMA somente as regiões que mudaram. Retorna false
+// se o envio anterior ainda estava em andamento: o desenho fica na RAM e sai no próximo envio
+bool desenha_tela(const instantaneo_t *instantaneo)
+{
+    // Quadro forçado pela taxa mínima: o envio deste quadro manda o painel inteiro
+    if (instantaneo->quadro_completo) {
+        ssd1306_invalidate(&ssd);
+    }
+
+    // Com a tela apagada nada é desenhado nem enviado; a RAM do display guarda o último quadro
+    if (instantaneo->brilho != brilho_exibido) {
+        ssd1306_set_power(&ssd, instantaneo->brilho != TELA_APAGADA);
+        ssd1306_set_contrast(&ssd, instantaneo->brilho == TELA_ACESA ? CONTRASTE_ACESA : CONTRASTE_ESCURA);
+        brilho_exibido = instantaneo->brilho;
+    }
+    if (instantaneo->brilho == TELA_APAGADA) {
+        return true;
+    }
+
+    TIMING_BEGIN(inicio_desenho);
+    if (instantaneo->estado == ESTADO_TEMPERATURA) {
+        if (tela_montada != ESTADO_TEMPERATURA) {
+            // Partes fixas da tela
+            ssd1306_fill(&ssd, false);
+            ssd1306_draw_string(&ssd, "Temperatura: ", 10, 10);
+            desenha_borda();
+            ssd1306_text_field_invalidate(&campo_temperatura);
+            for (uint linha = 0; linha < LINHAS_CANAIS; linha++) {
+                ssd1306_text_field_invalidate(&campo_canais[linha]);
+            }
+        }
+
+        // Mostra na tela a informações da temperatura
+        texto_temperatura(instantaneo->temperatura);
+        texto_canais(instantaneo);
+    } else if (instantaneo->estado == ESTADO_HISTORICO) {
+        tela_historico(instantaneo);
+    } else {
+        if (tela_montada != ESTADO_QUADRADO) {
+            // Parte fixa: só a borda. O quadrado é um sprite, movê-lo não redesenha a tela
+            ssd1306_fill(&ssd, false);
+            desenha_borda();
+            sprite_quadrado.visible = false;
+        }
+
+        // Converte os valores do joystick para coordenadas do display OLED
+        uint8_t pos_x, pos_y;
+        posicao_quadrado(instantaneo->adc_x, instantaneo->adc_y, &pos_x, &pos_y);
+
+        // Apaga o quadrado na posição antiga e o desenha na posição do joystick
+        ssd1306_sprite_move(&ssd, &sprite_quadrado, pos_x, pos_y);
+    }
+    tela_montada = instantaneo->estado;
+    TIMING_END(etapa_desenho, inicio_desenho);
+
+    // Sem bytes e sem envio em andamento, o quadro não tinha nada a mandar
+    TIMING_BEGIN(inicio_envio);
+    bool ocupado = ssd1306_send_busy(&ssd);
+    size_t bytes_enviados = ssd1306_send_dirty_async(&ssd);
+    TIMING_END(etapa_envio, inicio_envio);
+    DEBUG_PRINT("Display: %u bytes enviados\n", (unsigned)bytes_enviados);
+    return bytes_enviados || !ocupado;
+}
+
+// Tarefa dos LEDs: LED RGB (e a matriz WS2812 no modo de um núcleo)
+void tarefa_leds(void *dados)
+{
+    (void)dados;
+    TIMING_BEGIN(inicio_leds);
+    aciona_leds();
+    TIMING_END(etapa_leds, inicio_leds);
+
+#if !DUAL_CORE
+    instantaneo_t instantaneo;
+    captura_instantaneo(&instantaneo);
+    atualiza_matriz(&instantaneo);
+#endif
+}
+
+// Tarefa do display: compara o modelo da tela com o do último quadro e, se o controle da taxa
+// de quadros permitir, desenha a tela do estado atual ou, no modo DUAL_CORE, publica o
+// instantâneo para o núcleo 1
+void tarefa_display(void *dados)
+{
+    (void)dados;
+    instantaneo_t instantaneo;
+    captura_instantaneo(&instantaneo);
+
+    // O menu do quadrado precisa de uma taxa de quadros maior que a tela de temperatura
+    if (instantaneo.estado != estado_exibido) {
+        estado_exibido = instantaneo.estado;
+        aplica_periodos();
+    }
+
+    visao_t visao;
+    monta_visao(&instantaneo, &visao);
+    bool mudou = refresh_view_changed(&ultima_visao, &visao, sizeof(visao));
+    refresh_action_t acao = refresh_frame(&controle_tela, mudou, time_us_32());
+    if (acao == REFRESH_SKIP) {
+        return;
+    }
+    instantaneo.quadro_completo = acao == REFRESH_FULL;
+
+#if DUAL_CORE
+    snapshot_queue_publish(&fila_instantaneos, &instantaneo);
+    DEBUG_PRINT("Instantâneos: %u publicados | %u agregados\n",
+        (unsigned)fila_instantaneos.published, (unsigned)fila_instantaneos.coalesced);
+#else
+    // Com o envio anterior ainda no barramento, o quadro fica pendente: o modelo antigo continua
+    // valendo, então a próxima avaliação vê a mudança de novo, e o fim do envio dispara a tarefa.
+    // A marca vem antes do envio para um fim de envio no meio do caminho não se perder
+    quadro_pendente = true;
+    if (!desenha_tela(&instantaneo)) {
+        return;
+    }
+    quadro_pendente = false;
+#endif
+
+    // Só o que foi entregue à tela vira referência para o próximo quadro
+    memcpy(&ultima_visao, &visao, sizeof(visao));
+}
+
+#if !DUAL_CORE
+// Fim de um envio do display (interrupção do DMA): um quadro que encontrou o barramento ocupado
+// é avaliado de novo logo, sem esperar o período da tarefa (longo no modo de baixo consumo)
+static void envio_concluido(void *dados)
+{
+    (void)dados;
+    if (quadro_pendente) {
+        scheduler_trigger(tarefa_display_id);
+    }
+}
+#endif
+
+// Configura as saídas visuais: I2C e display OLED, e a matriz WS2812.
+// As interrupções de DMA do display ficam no núcleo que chama esta função
+void inicializa_saidas(void)
+{
     i2c_init(I2C_PORT, 400 * 1000);
     gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
     gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
@@ -99,102 +1093,151 @@ int main()
     ssd1306_config(&ssd);
     ssd1306_fill(&ssd, false);
     ssd1306_send_data(&ssd);
+    ssd1306_async_init(&ssd);
+    ssd1306_text_field_init(&campo_temperatura, 10, 20, 10);
+    ssd1306_text_field_init(&campo_estatisticas, 8, 4, 14);
+    for (uint linha = 0; linha < LINHAS_CANAIS; linha++) {
+        ssd1306_text_field_init(&campo_canais[linha], 8, 34 + 10 * linha, 14);
+    }
+    ssd1306_sprite_init(&sprite_quadrado, &sprite_atlas[SPRITE_SQUARE], SSD1306_BLIT_COPY);
 
-    adc_init();  
-    adc_gpio_init(SENSE); 
-    adc_select_input(0);
+    ws2812_init(&matriz, pio0, MATRIZ_PIN, MATRIZ_LADO, MATRIZ_LADO);
+    ws2812_set_brightness(&matriz, MATRIZ_BRILHO);
+}
 
-    gpio_init(LED_BLUE);
-    gpio_set_dir(LED_BLUE, GPIO_OUT);
+#if DUAL_CORE
+// Núcleo 1: dorme até chegar um instantâneo novo, desenha e envia.
+// Os instantâneos que chegam durante um envio lento são agregados no mais recente
+void nucleo1_main(void)
+{
+    // O núcleo 0 pausa este núcleo enquanto grava o log na flash
+    flash_safe_execute_core_init();
+    inicializa_saidas();
 
-    gpio_init(LED_RED);
-    gpio_set_dir(LED_RED, GPIO_OUT);
+    instantaneo_t instantaneo;
+    while (true) {
+        snapshot_queue_wait_latest(&fila_instantaneos, &instantaneo);
 
-    gpio_init(LED_GREEN);
-    gpio_set_dir(LED_GREEN, GPIO_OUT);
+        // A matriz só é reenviada quando a cor muda
+        atualiza_matriz(&instantaneo);
 
-    gpio_init(BUZZER);
-    gpio_set_dir(BUZZER, GPIO_OUT);
-    gpio_put(BUZZER, 0);
+        // O envio anterior termina antes do próximo para nenhuma alteração ficar para trás
+        ssd1306_send_wait(&ssd);
+        desenha_tela(&instantaneo);
+    }
+}
+#endif
 
-    gpio_init(BOTAO_A);
-    gpio_set_dir(BOTAO_A, GPIO_IN);
-    gpio_pull_up(BOTAO_A);
+// Filtro de bloco das entradas do joystick, na interrupção do DMA do ADC. O bloco tem 4^n
+// amostras da entrada e o FIR decima por 4^n, então sai exatamente um valor por bloco
+static uint32_t filtra_joystick(int16_t *amostras, uint quantidade, void *dados)
+{
+    filtro_joystick_t *filtro = dados;
+    int32_t saida = 0;
+    dsp_median(&filtro->mediana, amostras, amostras, quantidade);
+    dsp_fir_decimate(&filtro->fir, amostras, &saida, quantidade);
+    return saida < 0 ? 0 : (uint32_t)saida;
+}
 
-    gpio_init(BOTAO_B);
-    gpio_set_dir(BOTAO_B, GPIO_IN);
-    gpio_pull_up(BOTAO_B);
+static void inicializa_filtro(filtro_joystick_t *filtro, uint entrada)
+{
+    dsp_median_init(&filtro->mediana, FILTRO_MEDIANA);
+    dsp_fir_init(&filtro->fir, fir_joystick, FILTRO_FIR_COEFICIENTES, 1 << (2 * ADC_SOBREAMOSTRAGEM_BITS),
+        ADC_SOBREAMOSTRAGEM_BITS);
+    adc_acq_set_filter(entrada, filtra_joystick, filtro);
+}
 
-    init_matrix();
+// Devolve ao histórico uma amostra lida do log na inicialização
+static void restaura_amostra(const flash_log_record_t *registro, void *dados)
+{
+    (void)dados;
+    history_push(&historico, registro->value);
+}
 
-    gpio_set_irq_enabled_with_callback(BOTAO_A, GPIO_IRQ_EDGE_FALL, true, button_callback);
-    gpio_set_irq_enabled_with_callback(BOTAO_B, GPIO_IRQ_EDGE_FALL, true, button_callback);
+// Configura os periféricos, o display e as interrupções dos botões
+void inicializa(void)
+{
+    stdio_init_all();
 
-    while (true) {
-        uint16_t valor_adc = adc_read();
-        float tensao = (valor_adc * 3.3) / 4095;
-        float temperatura_simulada = (valor_adc / 4095.0f) * 50.0f;
-
-        // Exibe mensagens de depuração no terminal serial 
-        DEBUG_PRINT("ADC: %d | Tensão: %.2fV | Temperatura Simulada: %.2f\n", valor_adc, tensao, temperatura_simulada);
-
-        if (temperatura_simulada < 15.0) {
-            set_matrix_color(BLUE); // Acende a matriz de led na cor azul
-            gpio_put(LED_BLUE, 1);
-            gpio_put(LED_GREEN, 0);
-            gpio_put(LED_RED, 0);
-        } else if (temperatura_simulada > 35.0) {
-            set_matrix_color(RED); // Acende a matriz de led na cor vermelha
-            gpio_put(LED_RED, 1);
-            gpio_put(LED_BLUE, 0);
-            gpio_put(LED_GREEN, 0);
-            tone(BUZZER, 500, 350);
-        } else {
-            set_matrix_color(GREEN); // Acende a matriz de led na cor verde
-            gpio_put(LED_GREEN, 1);
-            gpio_put(LED_BLUE, 0);
-            gpio_put(LED_RED, 0);
-        }
-        // Limpar a tela
-        ssd1306_fill(&ssd, false);
+#if DUAL_CORE
+    snapshot_queue_init(&fila_instantaneos, fila_instantaneos_mem, sizeof(instantaneo_t));
+    multicore_launch_core1(nucleo1_main);
+#else
+    inicializa_saidas();
+#endif
 
-        // Mostra na tela a informações da temperatura
-        texto_temperatura(temperatura_simulada);
+    // ADC em modo livre percorrendo as entradas dos canais habilitados numa só varredura
+    adc_acq_config_t adc_config = {
+        .input_mask = sensor_input_mask(canais, NUM_CANAIS),
+        .sample_rate_hz = ADC_TAXA_CANAL_HZ * sensor_enabled_count(canais, NUM_CANAIS),
+        .oversample_bits = ADC_SOBREAMOSTRAGEM_BITS,
+    };
+    adc_acq_init(&adc_config);
+    // A temperatura (limites do alarme) e o quadrado usam as entradas filtradas
+    inicializa_filtro(&filtro_y, canais[CANAL_Y].input);
+    inicializa_filtro(&filtro_x, canais[CANAL_X].input);
+#if TELEMETRIA
+    // Um registro por bloco do ADC: ADC_TAXA_CANAL_HZ / 4^ADC_SOBREAMOSTRAGEM_BITS por segundo
+    telemetry_init(telemetria_escreve);
+    adc_acq_set_block_callback(telemetria_bloco);
+#endif
+    if (!modo_economia) {
+        adc_acq_start();
+    }
 
-        desenha_borda();
-        ssd1306_send_data(&ssd);
+    // Média exponencial do histórico com peso 1/8 para a amostra nova
+    history_init(&historico, HISTORICO_EMA_SHIFT);
+
+    // Retoma o log da flash e recupera as últimas amostras, para o gráfico não recomeçar vazio
+    flash_log_init();
+    uint32_t proximo = flash_log_next();
+    flash_log_read(proximo > HISTORY_CAPACITY ? proximo - HISTORY_CAPACITY : 0, restaura_amostra, NULL);
 
-        while(menu_quadrado){
-            // Definição dos Leds em branco
-            gpio_put(LED_BLUE, 1);
-            gpio_put(LED_GREEN, 1);
-            gpio_put(LED_RED, 1);
-            set_matrix_color(WHITE);
+    gpio_init(LED_BLUE);
+    gpio_set_dir(LED_BLUE, GPIO_OUT);
 
-            // Leitura do eixo X do joystick
-            adc_select_input(1);
-            uint16_t adc_x = adc_read();
+    gpio_init(LED_RED);
+    gpio_set_dir(LED_RED, GPIO_OUT);
 
-            // Leitura do eixo Y do joystick
-            adc_select_input(0);
-            uint16_t adc_y = adc_read();
+    gpio_init(LED_GREEN);
+    gpio_set_dir(LED_GREEN, GPIO_OUT);
 
-            // Exibe mensagens de depuração no terminal serial 
-            DEBUG_PRINT("ADC X: %d | ADC Y: %d\n", adc_x, adc_y);
+    buzzer_init(BUZZER);
 
-            // Limpar a tela
-            ssd1306_fill(&ssd, false);
+    // O motor de alarme dispara a tarefa de alarme a cada mudança de estado de um canal
+    alarm_init(notifica_alarme);
 
-            // Converte os valores do joystick para coordenadas do display OLED
-            uint8_t pos_x = (adc_x * (WIDTH - 8)) / 4095;
-            uint8_t pos_y = ((4095 - adc_y) * (HEIGHT - 8)) / 4095;
+    // A tela desenha o primeiro quadro na primeira execução da tarefa do display
+    refresh_init(&controle_tela, TAXA_MIN_MHZ, TAXA_MAX_TEMPERATURA_MHZ);
 
-            // Desenha um quadrado na posição do joystick
-            ssd1306_rect(&ssd, pos_y, pos_x, 8, 8, true, true);
-            
-            desenha_borda();
-            ssd1306_send_data(&ssd);
-        }
-        sleep_ms(50);
-    }
+    // Cada atividade é uma tarefa periódica; entre os prazos o processador dorme
+    tarefa_amostragem_id = scheduler_add("amostragem", tarefa_amostragem, NULL, 1000 * PERIODO_AMOSTRAGEM_MS, PRIORIDADE_AMOSTRAGEM);
+    tarefa_alarme_id = scheduler_add("alarme", tarefa_alarme, NULL, 1000 * PERIODO_ALARME_MS, PRIORIDADE_ALARME);
+    scheduler_add("historico", tarefa_historico, NULL, 1000 * PERIODO_HISTORICO_MS, PRIORIDADE_HISTORICO);
+    tarefa_leds_id = scheduler_add("leds", tarefa_leds, NULL, 1000 * PERIODO_LEDS_MS, PRIORIDADE_LEDS);
+    tarefa_display_id = scheduler_add("display", tarefa_display, NULL, 1000 * PERIODO_DISPLAY_TEMPERATURA_MS, PRIORIDADE_DISPLAY);
+#if !DUAL_CORE
+    ssd1306_set_send_callback(&ssd, envio_concluido, NULL);
+#endif
+#if TELEMETRIA
+    tarefa_telemetria_id = scheduler_add("telemetria", tarefa_telemetria, NULL, 1000 * PERIODO_TELEMETRIA_MS, PRIORIDADE_TELEMETRIA);
+#endif
+    tarefa_comandos_id = scheduler_add("comandos", tarefa_comandos, NULL, 1000 * PERIODO_COMANDOS_MS, PRIORIDADE_COMANDOS);
+    // Sem período: a tarefa dos botões só executa quando o subsistema de entrada a dispara
+    tarefa_botoes_id = scheduler_add("botoes", tarefa_botoes, NULL, 0, PRIORIDADE_BOTOES);
+    aplica_periodos();
+
+    // As interrupções dos botões só são ligadas com a tarefa que consome os eventos já criada
+    input_init(BOTOES_DEBOUNCE_US, BOTOES_TOQUE_LONGO_MS, BOTOES_REPETICAO_MS, notifica_botoes);
+    entrada_botao_a = input_add_button(BOTAO_A);
+    entrada_botao_b = input_add_button(BOTAO_B);
 }
+
+// No host (benchmarks) as tarefas são chamadas diretamente, sem o escalonador
+#ifndef SENSE_TEMP_HOST
+int main()
+{
+    inicializa();
+    scheduler_run();
+}
+#endif
@@ -0,0 +1,47 @@
+/*
+O arquivo sense_temp.h declara o que o firmware expõe para fora de sense_temp.c: as telas e as
+faixas de temperatura, as saídas e as tarefas. O benchmark e o simulador do host o incluem para
+dirigir o firmware com os mesmos tipos, sem repetir a ordem dos enumeradores.
+*/
+
+#ifndef SENSE_TEMP_H
+#define SENSE_TEMP_H
+
+#include "pico/stdlib.h"
+#include "lib/ssd1306.h"
+#include "lib/ws2812.h"
+#include "lib/refresh.h"
+
+// Telas da interface, alternadas pelos botões
+typedef enum {
+    ESTADO_TEMPERATURA,
+    ESTADO_QUADRADO,
+    ESTADO_HISTORICO
+} estado_t;
+
+// Faixas de temperatura avaliadas pela tarefa de alarme
+typedef enum {
+    FAIXA_BAIXA,
+    FAIXA_NORMAL,
+    FAIXA_ALTA
+} faixa_t;
+
+// Saídas visuais e estado da interface
+extern ssd1306_t ssd;
+extern ws2812_t matriz;
+extern volatile estado_t estado;
+extern faixa_t faixa, faixa_prevista;
+extern refresh_governor_t controle_tela;
+
+void inicializa(void);
+void define_modo(bool economia, uint32_t intervalo_ms);
+void aplica_periodos(void);
+
+// Tarefas do escalonador
+void tarefa_amostragem(void *dados);
+void tarefa_alarme(void *dados);
+void tarefa_leds(void *dados);
+void tarefa_display(void *dados);
+void tarefa_historico(void *dados);
+
+#endif